@@ -0,0 +1,524 @@
+/*
+ * MIDI CC Map X4 processor, shared by the plugin and the MIDI Chain
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2020 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_CCMAPX4_PROCESSOR_H
+#define MIDI_CCMAPX4_PROCESSOR_H
+
+#include "DistrhoPlugin.hpp"
+#include "MIDITransformProcessor.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+const ParameterEnumerationValue paramEnumDstChannels[] = {
+    {0,"Same as source"},
+    {1, "Channel 1"},
+    {2, "Channel 2"},
+    {3, "Channel 3"},
+    {4, "Channel 4"},
+    {5, "Channel 5"},
+    {6, "Channel 6"},
+    {7, "Channel 7"},
+    {8, "Channel 8"},
+    {9, "Channel 9"},
+    {10, "Channel 10"},
+    {11, "Channel 11"},
+    {12, "Channel 12"},
+    {13, "Channel 13"},
+    {14, "Channel 14"},
+    {15, "Channel 15"},
+    {16, "Channel 16"}
+};
+
+const ParameterEnumerationValue paramEnumModes[] {
+    {0, "Disabled"},
+    {1, "Map start/end range to min/max"},
+    {2, "Map full value range to min/max"}
+};
+
+// -----------------------------------------------------------------------
+
+// Settings derived from the parameters, see MidiTransformProcessor
+struct MidiCCMapX4Config {
+    // Settings of an enabled destination
+    struct Destination {
+        uint8_t cc;
+        int8_t channel;
+        bool filterDups;
+        uint8_t start, end;
+        // input and output range of the value mapping
+        uint8_t inMin, inMax, outMin, outMax;
+    };
+
+    Destination dests[4];
+    uint8_t numDests;
+    uint8_t sourceCC;
+};
+
+class MidiCCMapX4Processor : public MidiTransformProcessor<MidiCCMapX4Processor, MidiCCMapX4Config> {
+public:
+    enum Parameters {
+        paramFilterChannel,
+        paramCCSource,
+        paramKeepOriginal,
+        paramCC1Mode,
+        paramCC1Dest,
+        paramCC1Channel,
+        paramCC1FilterDups,
+        paramCC1Start,
+        paramCC1End,
+        paramCC1Min,
+        paramCC1Max,
+        paramCC2Mode,
+        paramCC2Dest,
+        paramCC2Channel,
+        paramCC2FilterDups,
+        paramCC2Start,
+        paramCC2End,
+        paramCC2Min,
+        paramCC2Max,
+        paramCC3Mode,
+        paramCC3Dest,
+        paramCC3Channel,
+        paramCC3FilterDups,
+        paramCC3Start,
+        paramCC3End,
+        paramCC3Min,
+        paramCC3Max,
+        paramCC4Mode,
+        paramCC4Dest,
+        paramCC4Channel,
+        paramCC4FilterDups,
+        paramCC4Start,
+        paramCC4End,
+        paramCC4Min,
+        paramCC4Max,
+        paramCount
+    };
+
+    enum PortGroups {
+        kPortGroupSource,
+        kPortGroupCC1,
+        kPortGroupCC2,
+        kPortGroupCC3,
+        kPortGroupCC4,
+        kPortGroupCount
+    };
+
+    MidiCCMapX4Processor()
+        : MidiTransformProcessor(MIDI_CONTROL_CHANGE),
+          fParams()
+    {
+        reset();
+        loadDefaults();
+    }
+
+    void reset() override {
+        for (uint8_t ch=0; ch<16; ch++) {
+            for (uint8_t cc=0; cc<128; cc++) {
+                lastCCValue[ch][cc] = -1;
+            }
+        }
+    }
+
+    uint32_t getParameterCount() const override {
+        return paramCount;
+    }
+
+    void initParameter(uint32_t index, Parameter& parameter) const override {
+        if (index >= paramCount)
+            return;
+
+        parameter.hints = kParameterIsAutomable | kParameterIsInteger;
+        parameter.ranges.def = 0;
+        parameter.ranges.min = 0;
+        parameter.ranges.max = 127;
+
+        switch (index) {
+            case paramFilterChannel:
+                initFilterChannelParameter(parameter);
+                break;
+            case paramCCSource:
+                parameter.name = "Source CC";
+                parameter.symbol = "cc_source";
+                parameter.ranges.def = 1;
+                break;
+            case paramKeepOriginal:
+                initKeepOriginalParameter(parameter, "Keep Source CC Events", "Keep src. CC");
+                break;
+            case paramCC1Mode:
+                parameter.name = "CC 1 Mode";
+                parameter.shortName = "CC1 Mode";
+                parameter.symbol = "cc1_mode";
+                parameter.ranges.max = 2;
+                parameter.enumValues.restrictedMode = true;
+                setEnumValues(parameter.enumValues, paramEnumModes);
+                break;
+            case paramCC1Dest:
+                parameter.name = "CC 1 Destination";
+                parameter.shortName = "CC1 Dest.";
+                parameter.symbol = "cc1_dest";
+                parameter.ranges.def = 14;
+                break;
+            case paramCC1Channel:
+                parameter.name = "CC1 Channel";
+                parameter.symbol = "cc1_chan";
+                parameter.ranges.max = 16;
+                parameter.enumValues.restrictedMode = true;
+                setEnumValues(parameter.enumValues, paramEnumDstChannels);
+                break;
+            case paramCC1FilterDups:
+                parameter.name = "CC 1 Filter repeated values";
+                parameter.shortName = "CC1 Filter dups";
+                parameter.symbol = "cc1_filterdups";
+                parameter.ranges.def = 1;
+                parameter.ranges.max = 1;
+                parameter.hints |= kParameterIsBoolean;
+                break;
+            case paramCC1Start:
+                parameter.name = "CC 1 Start";
+                parameter.shortName = "CC1 Start";
+                parameter.symbol = "cc1_start";
+                break;
+            case paramCC1End:
+                parameter.name = "CC 1 End";
+                parameter.shortName = "CC1 End";
+                parameter.symbol = "cc1_end";
+                parameter.ranges.def = 127;
+                break;
+            case paramCC1Min:
+                parameter.name = "CC 1 Minimum value";
+                parameter.shortName = "CC1 Min. value";
+                parameter.symbol = "cc1_min";
+                break;
+            case paramCC1Max:
+                parameter.name = "CC 1 Maximum value";
+                parameter.shortName = "CC1 Max. value";
+                parameter.symbol = "cc1_max";
+                parameter.ranges.def = 127;
+                break;
+            case paramCC2Mode:
+                parameter.name = "CC 2 Mode";
+                parameter.shortName = "CC2 Mode";
+                parameter.symbol = "cc2_mode";
+                parameter.ranges.max = 2;
+                parameter.enumValues.restrictedMode = true;
+                setEnumValues(parameter.enumValues, paramEnumModes);
+                break;
+            case paramCC2Dest:
+                parameter.name = "CC 2 Destination";
+                parameter.shortName = "CC2 Dest.";
+                parameter.symbol = "cc2_dest";
+                parameter.ranges.def = 15;
+                break;
+            case paramCC2Channel:
+                parameter.name = "CC2 Channel";
+                parameter.symbol = "cc2_chan";
+                parameter.ranges.max = 16;
+                parameter.enumValues.restrictedMode = true;
+                setEnumValues(parameter.enumValues, paramEnumDstChannels);
+                break;
+            case paramCC2FilterDups:
+                parameter.name = "CC 2 Filter repeated values";
+                parameter.shortName = "CC2 Filter dups";
+                parameter.symbol = "cc2_filterdups";
+                parameter.ranges.def = 1;
+                parameter.ranges.max = 1;
+                parameter.hints |= kParameterIsBoolean;
+                parameter.ranges.max = 1;
+                break;
+            case paramCC2Start:
+                parameter.name = "CC 2 Start";
+                parameter.shortName = "CC2 Start";
+                parameter.symbol = "cc2_start";
+                break;
+            case paramCC2End:
+                parameter.name = "CC 2 End";
+                parameter.shortName = "CC2 End";
+                parameter.symbol = "cc2_end";
+                parameter.ranges.def = 127;
+                break;
+            case paramCC2Min:
+                parameter.name = "CC 2 Minimum value";
+                parameter.shortName = "CC2 Min. value";
+                parameter.symbol = "cc2_min";
+                break;
+            case paramCC2Max:
+                parameter.name = "CC 2 Maximum value";
+                parameter.shortName = "CC2 Max. value";
+                parameter.symbol = "cc2_max";
+                parameter.ranges.def = 127;
+                break;
+            case paramCC3Mode:
+                parameter.name = "CC 3 Mode";
+                parameter.shortName = "CC3 Mode";
+                parameter.symbol = "cc3_mode";
+                parameter.ranges.max = 2;
+                parameter.enumValues.restrictedMode = true;
+                setEnumValues(parameter.enumValues, paramEnumModes);
+                break;
+            case paramCC3Dest:
+                parameter.name = "CC 3 Destination";
+                parameter.shortName = "CC3 Dest.";
+                parameter.symbol = "cc3_dest";
+                parameter.ranges.def = 16;
+                break;
+            case paramCC3Channel:
+                parameter.name = "CC3 Channel";
+                parameter.symbol = "cc3_chan";
+                parameter.ranges.max = 16;
+                parameter.enumValues.restrictedMode = true;
+                setEnumValues(parameter.enumValues, paramEnumDstChannels);
+                break;
+            case paramCC3FilterDups:
+                parameter.name = "CC 3 Filter repeated values";
+                parameter.shortName = "CC3 Filter dups";
+                parameter.symbol = "cc3_filterdups";
+                parameter.ranges.def = 1;
+                parameter.ranges.max = 1;
+                parameter.hints |= kParameterIsBoolean;
+                break;
+            case paramCC3Start:
+                parameter.name = "CC 3 Start";
+                parameter.shortName = "CC3 Start";
+                parameter.symbol = "cc3_start";
+                break;
+            case paramCC3End:
+                parameter.name = "CC 3 End";
+                parameter.shortName = "CC3 End";
+                parameter.symbol = "cc3_end";
+                parameter.ranges.def = 127;
+                break;
+            case paramCC3Min:
+                parameter.name = "CC 3 Minimum value";
+                parameter.shortName = "CC3 Min. value";
+                parameter.symbol = "cc3_min";
+                break;
+            case paramCC3Max:
+                parameter.name = "CC 3 Maximum value";
+                parameter.shortName = "CC3 Max. value";
+                parameter.symbol = "cc3_max";
+                parameter.ranges.def = 127;
+                break;
+            case paramCC4Mode:
+                parameter.name = "CC 4 Mode";
+                parameter.shortName = "CC4 Mode";
+                parameter.symbol = "cc4_mode";
+                parameter.ranges.max = 2;
+                parameter.enumValues.restrictedMode = true;
+                setEnumValues(parameter.enumValues, paramEnumModes);
+                break;
+            case paramCC4Dest:
+                parameter.name = "CC 4 Destination";
+                parameter.shortName = "CC4 Dest.";
+                parameter.symbol = "cc4_dest";
+                parameter.ranges.def = 17;
+                break;
+            case paramCC4Channel:
+                parameter.name = "CC4 Channel";
+                parameter.symbol = "cc4_chan";
+                parameter.ranges.max = 16;
+                parameter.enumValues.restrictedMode = true;
+                setEnumValues(parameter.enumValues, paramEnumDstChannels);
+                break;
+            case paramCC4FilterDups:
+                parameter.name = "CC 4 Filter repeated values";
+                parameter.shortName = "CC4 Filter dups";
+                parameter.symbol = "cc4_filterdups";
+                parameter.ranges.def = 1;
+                parameter.ranges.max = 1;
+                parameter.hints |= kParameterIsBoolean;
+                break;
+            case paramCC4Start:
+                parameter.name = "CC  Start";
+                parameter.shortName = "CC4 Start";
+                parameter.symbol = "cc4_start";
+                break;
+            case paramCC4End:
+                parameter.name = "CC 4 End";
+                parameter.shortName = "CC4 End";
+                parameter.symbol = "cc4_end";
+                parameter.ranges.def = 127;
+                break;
+            case paramCC4Min:
+                parameter.name = "CC 4 Minimum value";
+                parameter.shortName = "CC4 Min. value";
+                parameter.symbol = "cc4_min";
+                break;
+            case paramCC4Max:
+                parameter.name = "CC 4 Maximum value";
+                parameter.shortName = "CC4 Max. value";
+                parameter.symbol = "cc4_max";
+                parameter.ranges.def = 127;
+                break;
+       }
+
+#if DISTRHO_PLUGIN_WANT_PORT_GROUPS
+        if (index < paramCC1Mode)
+            parameter.group = kPortGroupSource;
+        else
+            parameter.group = kPortGroupCC1 + (index - paramCC1Mode) / 8;
+#endif
+    }
+
+    float getParameterValue(uint32_t index) const override {
+        return fParams[index];
+    }
+
+private:
+    friend class MidiTransformProcessor<MidiCCMapX4Processor, MidiCCMapX4Config>;
+
+    void storeParameter(uint32_t index, float value) {
+        switch (index) {
+            case paramFilterChannel:
+                fParams[index] = setFilterChannel(value);
+                break;
+            case paramCC1Channel:
+            case paramCC2Channel:
+            case paramCC3Channel:
+            case paramCC4Channel:
+                fParams[index] = clamp(value, 0.0f, 16.0f);
+                break;
+            case paramKeepOriginal:
+                fParams[index] = setKeepOriginal(value);
+                break;
+            case paramCC1FilterDups:
+            case paramCC2FilterDups:
+            case paramCC3FilterDups:
+            case paramCC4FilterDups:
+                fParams[index] = clamp(value, 0.0f, 1.0f);
+                break;
+            case paramCC1Mode:
+            case paramCC2Mode:
+            case paramCC3Mode:
+            case paramCC4Mode:
+                fParams[index] = clamp(value, 0.0f, 2.0f);
+                break;
+            case paramCCSource:
+            case paramCC1Dest:
+            case paramCC1Min:
+            case paramCC1Max:
+            case paramCC1Start:
+            case paramCC1End:
+            case paramCC2Dest:
+            case paramCC2Min:
+            case paramCC2Max:
+            case paramCC2Start:
+            case paramCC2End:
+            case paramCC3Dest:
+            case paramCC3Min:
+            case paramCC3Max:
+            case paramCC3Start:
+            case paramCC3End:
+            case paramCC4Dest:
+            case paramCC4Min:
+            case paramCC4Max:
+            case paramCC4Start:
+            case paramCC4End:
+                fParams[index] = clamp(value, 0.0f, 127.0f);
+                break;
+        }
+    }
+
+    /**
+      Collect the settings of all enabled destinations into a compact table,
+      which resolves the mode switch and the parameter casts up front.
+      If all destinations are disabled, the processor is idle and with "Keep
+      Source CC Events" on, events are forwarded without decoding.
+    */
+    bool updateConfig(MidiCCMapX4Config& config) const {
+        uint8_t numDests = 0;
+
+        for (int dest=0; dest<4; dest++) {
+            const float* params = fParams + paramCC1Mode + (8 * dest);
+            const uint8_t mode = (uint8_t) params[0];
+
+            if (mode != 1 && mode != 2)
+                continue;
+
+            MidiCCMapX4Config::Destination& dst = config.dests[numDests++];
+            dst.cc = (uint8_t) params[1];
+            dst.channel = (int8_t) params[2] - 1;
+            dst.filterDups = (bool) params[3];
+            dst.start = (uint8_t) params[4];
+            dst.end = (uint8_t) params[5];
+            dst.inMin = mode == 1 ? dst.start : 0;
+            dst.inMax = mode == 1 ? dst.end : 127;
+            dst.outMin = (uint8_t) params[6];
+            dst.outMax = (uint8_t) params[7];
+        }
+
+        config.numDests = numDests;
+        config.sourceCC = (uint8_t) fParams[paramCCSource];
+        return numDests > 0;
+    }
+
+    template <class Sink>
+    inline bool transform(const MidiEvent& event, const MidiCCMapX4Config& config, Sink& out) {
+        uint8_t chan, cc_val, new_val;
+        int8_t cc_chan;
+        struct MidiEvent cc_event;
+
+        if ((event.data[1] & 0x7f) != config.sourceCC)
+            return false;
+
+        chan = event.data[0] & 0x0F;
+        cc_val = event.data[2] & 0x7f;
+
+        for (uint8_t dest=0; dest<config.numDests; dest++) {
+            const MidiCCMapX4Config::Destination& dst = config.dests[dest];
+
+            if (!inRange(cc_val, dst.start, dst.end))
+                continue;
+
+            new_val = (uint8_t) mapRange<int32_t>(cc_val, dst.inMin, dst.inMax, dst.outMin, dst.outMax);
+            cc_chan = dst.channel == -1 ? chan : dst.channel;
+
+            if (dst.filterDups && new_val == lastCCValue[cc_chan][dst.cc])
+                continue;
+
+            cc_event.frame = event.frame;
+            cc_event.size = 3;
+            cc_event.data[0] = MIDI_CONTROL_CHANGE | cc_chan;
+            cc_event.data[1] = dst.cc;
+            cc_event.data[2] = new_val;
+            lastCCValue[cc_chan][dst.cc] = new_val;
+            out.write(cc_event);
+        }
+
+        return true;
+    }
+
+    float fParams[paramCount];
+    int8_t lastCCValue[16][128];
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_CCMAPX4_PROCESSOR_H
@@ -28,74 +28,15 @@
 #define PLUGIN_MIDICCMAPX4_H
 
 #include "DistrhoPlugin.hpp"
+#include "MIDICCMapX4Processor.hpp"
+#include "MIDIProcessorPlugin.hpp"
 
 START_NAMESPACE_DISTRHO
 
-#ifndef IN_RANGE
-#define IN_RANGE(v, min, max) ((min) <= (max) ? ((v) >= (min) && (v) <= (max)) : ((v) >= (min) || (v) <= (max)))
-#endif
-
-#ifndef MAP
-#define MAP(v, imin, imax, omin, omax) (((v) - (imin)) * ((omax) - (omin)) / ((imax) - (imin)) + (omin))
-#endif
-
-#ifndef MIN
-#define MIN(a,b) ( (a) < (b) ? (a) : (b) )
-#endif
-
-#ifndef MAX
-#define MAX(a,b) ( (a) > (b) ? (a) : (b) )
-#endif
-
-#ifndef CLAMP
-#define CLAMP(v, min, max) (MIN((max), MAX((min), (v))))
-#endif
-
-#define MIDI_CONTROL_CHANGE 0xB0
-
 // -----------------------------------------------------------------------
 
-class PluginMIDICCMapX4 : public Plugin {
+class PluginMIDICCMapX4 : public MidiProcessorPlugin<MidiCCMapX4Processor> {
 public:
-    enum Parameters {
-        paramFilterChannel,
-        paramCCSource,
-        paramKeepOriginal,
-        paramCC1Mode,
-        paramCC1Dest,
-        paramCC1Channel,
-        paramCC1FilterDups,
-        paramCC1Start,
-        paramCC1End,
-        paramCC1Min,
-        paramCC1Max,
-        paramCC2Mode,
-        paramCC2Dest,
-        paramCC2Channel,
-        paramCC2FilterDups,
-        paramCC2Start,
-        paramCC2End,
-        paramCC2Min,
-        paramCC2Max,
-        paramCC3Mode,
-        paramCC3Dest,
-        paramCC3Channel,
-        paramCC3FilterDups,
-        paramCC3Start,
-        paramCC3End,
-        paramCC3Min,
-        paramCC3Max,
-        paramCC4Mode,
-        paramCC4Dest,
-        paramCC4Channel,
-        paramCC4FilterDups,
-        paramCC4Start,
-        paramCC4End,
-        paramCC4Min,
-        paramCC4Max,
-        paramCount
-    };
-
     PluginMIDICCMapX4();
 
 protected:
@@ -138,15 +79,12 @@ protected:
     // -------------------------------------------------------------------
     // Init
 
-    void initParameter(uint32_t index, Parameter& parameter) override;
     void initPortGroup(uint32_t index, PortGroup& pgroup) override;
     void initProgramName(uint32_t index, String& programName) override;
 
     // -------------------------------------------------------------------
     // Internal data
 
-    float getParameterValue(uint32_t index) const override;
-    void setParameterValue(uint32_t index, float value) override;
     void loadProgram(uint32_t index) override;
 
     // -------------------------------------------------------------------
@@ -160,17 +98,9 @@ protected:
 
     void activate() override;
 
-    void run(const float**, float**, uint32_t,
-             const MidiEvent* midiEvents, uint32_t midiEventCount) override;
-
-
     // -------------------------------------------------------------------
 
 private:
-    float fParams[paramCount];
-    int8_t filterChannel;
-    int8_t lastCCValue[16][128];
-
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginMIDICCMapX4)
 };
 
@@ -24,20 +24,125 @@
  * IN THE SOFTWARE.
  */
 
-// #include <iostream>
-#include <iomanip>
-#include <vector>
-
 #include "PluginMIDICCRecorder.hpp"
-#include "extra/Base64.hpp"
 
 START_NAMESPACE_DISTRHO
 
 // -----------------------------------------------------------------------
 
+static const ParameterEnumerationValue paramEnumTrigTransport[] = {
+    {0, "Disabled"},
+    {1, "Always"},
+    {2, "Only at Position 0"}
+};
+
+static const ParameterEnumerationValue paramEnumTrigPCChannels[] = {
+    {0, "Any channel"},
+    {1, "Channel 1"},
+    {2, "Channel 2"},
+    {3, "Channel 3"},
+    {4, "Channel 4"},
+    {5, "Channel 5"},
+    {6, "Channel 6"},
+    {7, "Channel 7"},
+    {8, "Channel 8"},
+    {9, "Channel 9"},
+    {10, "Channel 10"},
+    {11, "Channel 11"},
+    {12, "Channel 12"},
+    {13, "Channel 13"},
+    {14, "Channel 14"},
+    {15, "Channel 15"},
+    {16, "Channel 16"},
+    {17, "Disabled"}
+};
+
+static const ParameterEnumerationValue paramEnumSendChannels[] = {
+    {0, "All"},
+    {1, "Channel 1"},
+    {2, "Channel 2"},
+    {3, "Channel 3"},
+    {4, "Channel 4"},
+    {5, "Channel 5"},
+    {6, "Channel 6"},
+    {7, "Channel 7"},
+    {8, "Channel 8"},
+    {9, "Channel 9"},
+    {10, "Channel 10"},
+    {11, "Channel 11"},
+    {12, "Channel 12"},
+    {13, "Channel 13"},
+    {14, "Channel 14"},
+    {15, "Channel 15"},
+    {16, "Channel 16"}
+};
+
+// -----------------------------------------------------------------------
+
+/**
+  Parse the channel index from a state key of the form "ch-NN".
+  Returns -1 if @a key is not a valid channel state key.
+*/
+static int parseStateKey(const char* key) {
+    int index = 0;
+
+    if (std::strncmp(key, "ch-", 3) != 0 || key[3] == '\0')
+        return -1;
+
+    for (const char* c = key + 3; *c; c++) {
+        if (*c < '0' || *c > '9' || index >= (int) stateCount)
+            return -1;
+
+        index = index * 10 + (*c - '0');
+    }
+
+    return index < (int) stateCount ? index : -1;
+}
+
+/**
+  Decode the base64 string @a value into @a buf, storing at most @a size
+  bytes, without allocating any memory. Returns the number of bytes stored.
+*/
+static uint32_t decodeBase64(const char* value, uint8_t* buf, uint32_t size) {
+    uint32_t bits = 0, numBits = 0, count = 0;
+
+    for (const char* c = value; *c && *c != '=' && count < size; c++) {
+        uint32_t digit;
+
+        if (*c >= 'A' && *c <= 'Z')
+            digit = *c - 'A';
+        else if (*c >= 'a' && *c <= 'z')
+            digit = *c - 'a' + 26;
+        else if (*c >= '0' && *c <= '9')
+            digit = *c - '0' + 52;
+        else if (*c == '+')
+            digit = 62;
+        else if (*c == '/')
+            digit = 63;
+        else
+            continue;
+
+        bits = (bits << 6) | digit;
+        numBits += 6;
+
+        if (numBits >= 8) {
+            numBits -= 8;
+            buf[count++] = (bits >> numBits) & 0xFF;
+        }
+    }
+
+    return count;
+}
+
+// -----------------------------------------------------------------------
+
 PluginMIDICCRecorder::PluginMIDICCRecorder()
-    : Plugin(paramCount, presetCount, stateCount), playing(false)
+    : Plugin(paramCount + MidiEventCounters::kCount, presetCount, stateCount),
+      fSampleRate(getSampleRate()), playing(false), sendInProgress(false),
+      fSendPaused(false), fNextFrame(0), fSendInterval(0)
 {
+    fClassifier.addMatch(MIDI_CONTROL_CHANGE);
+    fClassifier.addMatch(MIDI_PROGRAM_CHANGE);
     clearState();
     loadProgram(0);
 }
@@ -46,8 +151,10 @@ PluginMIDICCRecorder::PluginMIDICCRecorder()
 // Init
 
 void PluginMIDICCRecorder::initParameter(uint32_t index, Parameter& parameter) {
-    if (index >= paramCount)
+    if (index >= paramCount) {
+        MidiEventCounters::initParameter(index - paramCount, parameter);
         return;
+    }
 
     parameter.hints = kParameterIsAutomable | kParameterIsInteger;
     parameter.ranges.def = 0;
@@ -75,18 +182,8 @@ void PluginMIDICCRecorder::initParameter(uint32_t index, Parameter& parameter) {
             parameter.shortName = "Transport";
             parameter.symbol = "trig_transport";
             parameter.ranges.max = 2;
-            parameter.enumValues.count = 3;
             parameter.enumValues.restrictedMode = true;
-            {
-                ParameterEnumerationValue* const channels = new ParameterEnumerationValue[3];
-                parameter.enumValues.values = channels;
-                channels[0].label = "Disabled";
-                channels[0].value = 0;
-                channels[1].label = "Always";
-                channels[1].value = 1;
-                channels[2].label = "Only at Position 0";
-                channels[2].value = 2;
-            }
+            setEnumValues(parameter.enumValues, paramEnumTrigTransport);
             break;
         case paramTrigPCChannel:
             parameter.name = "Trigger send on PC?";
@@ -94,48 +191,8 @@ void PluginMIDICCRecorder::initParameter(uint32_t index, Parameter& parameter) {
             parameter.symbol = "trig_pc_chan";
             parameter.ranges.def = 17;
             parameter.ranges.max = 17;
-            parameter.enumValues.count = 18;
             parameter.enumValues.restrictedMode = true;
-            {
-                ParameterEnumerationValue* const channels = new ParameterEnumerationValue[18];
-                parameter.enumValues.values = channels;
-                channels[0].label = "Any channel";
-                channels[0].value = 0;
-                channels[1].label = "Channel 1";
-                channels[1].value = 1;
-                channels[2].label = "Channel 2";
-                channels[2].value = 2;
-                channels[3].label = "Channel 3";
-                channels[3].value = 3;
-                channels[4].label = "Channel 4";
-                channels[4].value = 4;
-                channels[5].label = "Channel 5";
-                channels[5].value = 5;
-                channels[6].label = "Channel 6";
-                channels[6].value = 6;
-                channels[7].label = "Channel 7";
-                channels[7].value = 7;
-                channels[8].label = "Channel 8";
-                channels[8].value = 8;
-                channels[9].label = "Channel 9";
-                channels[9].value = 9;
-                channels[10].label = "Channel 10";
-                channels[10].value = 10;
-                channels[11].label = "Channel 11";
-                channels[11].value = 11;
-                channels[12].label = "Channel 12";
-                channels[12].value = 12;
-                channels[13].label = "Channel 13";
-                channels[13].value = 13;
-                channels[14].label = "Channel 14";
-                channels[14].value = 14;
-                channels[15].label = "Channel 15";
-                channels[15].value = 15;
-                channels[16].label = "Channel 16";
-                channels[16].value = 16;
-                channels[17].label = "Disabled";
-                channels[17].value = 17;
-            }
+            setEnumValues(parameter.enumValues, paramEnumTrigPCChannels);
             break;
         case paramTrigPC:
             parameter.name = "Program number";
@@ -146,46 +203,8 @@ void PluginMIDICCRecorder::initParameter(uint32_t index, Parameter& parameter) {
             parameter.name = "Send channel";
             parameter.symbol = "send_chan";
             parameter.ranges.max = 16;
-            parameter.enumValues.count = 17;
             parameter.enumValues.restrictedMode = true;
-            {
-                ParameterEnumerationValue* const channels = new ParameterEnumerationValue[17];
-                parameter.enumValues.values = channels;
-                channels[0].label = "All";
-                channels[0].value = 0;
-                channels[1].label = "Channel 1";
-                channels[1].value = 1;
-                channels[2].label = "Channel 2";
-                channels[2].value = 2;
-                channels[3].label = "Channel 3";
-                channels[3].value = 3;
-                channels[4].label = "Channel 4";
-                channels[4].value = 4;
-                channels[5].label = "Channel 5";
-                channels[5].value = 5;
-                channels[6].label = "Channel 6";
-                channels[6].value = 6;
-                channels[7].label = "Channel 7";
-                channels[7].value = 7;
-                channels[8].label = "Channel 8";
-                channels[8].value = 8;
-                channels[9].label = "Channel 9";
-                channels[9].value = 9;
-                channels[10].label = "Channel 10";
-                channels[10].value = 10;
-                channels[11].label = "Channel 11";
-                channels[11].value = 11;
-                channels[12].label = "Channel 12";
-                channels[12].value = 12;
-                channels[13].label = "Channel 13";
-                channels[13].value = 13;
-                channels[14].label = "Channel 14";
-                channels[14].value = 14;
-                channels[15].label = "Channel 15";
-                channels[15].value = 15;
-                channels[16].label = "Channel 16";
-                channels[16].value = 16;
-            }
+            setEnumValues(parameter.enumValues, paramEnumSendChannels);
             break;
         case paramSendInterval:
             parameter.name = "Send interval (ms)";
@@ -229,12 +248,24 @@ void PluginMIDICCRecorder::initProgramName(uint32_t index, String& programName)
 */
 void PluginMIDICCRecorder::sampleRateChanged(double newSampleRate) {
     fSampleRate = newSampleRate;
+    updateSendInterval();
+}
+
+/**
+  Convert the send interval parameter into frames, so sending does not need
+  to do this for every event.
+*/
+void PluginMIDICCRecorder::updateSendInterval() {
+    fSendInterval = (uint32_t) (fSampleRate / 1000 * fParams[paramSendInterval]);
 }
 
 /**
   Get the current value of a parameter.
 */
 float PluginMIDICCRecorder::getParameterValue(uint32_t index) const {
+    if (index >= paramCount)
+        return fCounters.getValue(index - paramCount);
+
     return fParams[index];
 }
 
@@ -244,36 +275,37 @@ float PluginMIDICCRecorder::getParameterValue(uint32_t index) const {
 void PluginMIDICCRecorder::setParameterValue(uint32_t index, float value) {
     switch (index) {
         case paramRecordEnable:
-            fParams[index] = CLAMP(value, 0, 1);
+            fParams[index] = clamp(value, 0.0f, 1.0f);
             break;
         case paramTrigClear:
-            fParams[index] = CLAMP(value, 0, 1);
+            fParams[index] = clamp(value, 0.0f, 1.0f);
 
             if (fParams[index] > 0.0f)
-                clearState();
+                fCommands.push(cmdClear);
 
             break;
         case paramTrigSend:
-            fParams[index] = CLAMP(value, 0, 1);
+            fParams[index] = clamp(value, 0.0f, 1.0f);
 
             if (fParams[index] > 0.0f)
-                startSend();
+                fCommands.push(cmdSend);
 
             break;
         case paramTrigTransport:
-            fParams[index] = CLAMP(value, 0, 2);
+            fParams[index] = clamp(value, 0.0f, 2.0f);
             break;
         case paramTrigPCChannel:
-            fParams[index] = CLAMP(value, 0, 17);
+            fParams[index] = clamp(value, 0.0f, 17.0f);
             break;
         case paramTrigPC:
-            fParams[index] = CLAMP(value, 0, 127);
+            fParams[index] = clamp(value, 0.0f, 127.0f);
             break;
         case paramSendChannel:
-            fParams[index] = CLAMP(value, 0, 16);
+            fParams[index] = clamp(value, 0.0f, 16.0f);
             break;
         case paramSendInterval:
-            fParams[index] = CLAMP(value, 0, 200);
+            fParams[index] = clamp(value, 0.0f, 200.0f);
+            updateSendInterval();
             break;
     }
 }
@@ -283,22 +315,14 @@ void PluginMIDICCRecorder::setParameterValue(uint32_t index, float value) {
   The host may call this function from any non-realtime context.
 */
 String PluginMIDICCRecorder::getState(const char* key) const {
-    static const String sFalse("false");
-    int index;
-
-    if (std::strncmp(key, "ch-", 3) == 0) {
-        try {
-            index = std::stoi(key+3);
-        } catch (...) {
-            return sFalse;
-        }
+    int index = parseStateKey(key);
 
-        if (index < (int) stateCount) {
-            return String::asBase64((char *) stateCC[index], 128);
-        }
-    }
+    MIDI_PROBE1(state_save, key);
+
+    if (index >= 0)
+        return String::asBase64((char *) stateCC[index], NUM_CONTROLLERS);
 
-    return sFalse;
+    return String("false");
 }
 
 
@@ -306,31 +330,13 @@ String PluginMIDICCRecorder::getState(const char* key) const {
   Change an internal state.
 */
 void PluginMIDICCRecorder::setState(const char* key, const char* value) {
-    int index;
-
-    if (std::strncmp(key, "ch-", 3) == 0) {
-        try {
-            index = std::stoi(key+3);
-        } catch (...) {
-            return;
-        }
-
-        if (index < (int) stateCount) {
-            if (!std::strcmp(value, "false") == 0) {
-                std::vector<uint8_t> state = d_getChunkFromBase64String(value);
+    int index = parseStateKey(key);
 
-                for (uint i=0; i < state.size(); i++) {
-                    stateCC[index][i] = state[i];
-                }
+    MIDI_PROBE1(state_load, key);
 
-                // std::cerr << "State 'ch-" << index << "': ";
-                // for (uint i=0; i < 128; i++) {
-                //     std::cerr << (uint) stateCC[index][i] << ",";
-                // }
-                // std::cerr << std::endl;
-            }
-        }
-    }
+    // decode in place, without a temporary buffer
+    if (index >= 0 && std::strcmp(value, "false") != 0)
+        decodeBase64(value, stateCC[index], NUM_CONTROLLERS);
 }
 
 
@@ -367,72 +373,113 @@ void PluginMIDICCRecorder::loadProgram(uint32_t index) {
  */
 void PluginMIDICCRecorder::activate() {
     fSampleRate = getSampleRate();
+    updateSendInterval();
     sendInProgress = false;
+    fSendPaused = false;
+    fNextFrame = 0;
     curChan = 0;
     curCC = 0;
 }
 
 /*
- *  Start sending.
+ *  Start sending, beginning at @a frame of the current block.
  */
-void PluginMIDICCRecorder::startSend() {
+void PluginMIDICCRecorder::startSend(uint32_t frame) {
     if (!sendInProgress) {
         sendChannel = fParams[paramSendChannel];
         curChan = 0;
         curCC = 0;
+        fNextFrame = frame;
     }
 
     sendInProgress = true;
 }
 
+/*
+ *  Carry out the actions of trigger parameters queued since the last block.
+ *
+ *  setParameterValue() may be called from another thread than run(), so it
+ *  only queues them. The host does not tell the frame of a parameter change,
+ *  so they take effect at the start of the block unless the command says
+ *  otherwise.
+ */
+void PluginMIDICCRecorder::runCommands(uint32_t nframes) {
+    MidiCommandQueue::Command cmd;
 
+    while (fCommands.pop(cmd)) {
+        switch (cmd.id) {
+            case cmdClear:
+                clearState();
+                break;
+            case cmdSend:
+                startSend(cmd.frame < nframes ? cmd.frame : 0);
+                break;
+        }
+    }
+}
 
-void PluginMIDICCRecorder::run(const float**, float**, uint32_t nframes,
-                               const MidiEvent* events, uint32_t eventCount) {
-    uint8_t cc, chan, status;
+/*
+ *  Send stored CCs scheduled before @a frame.
+ *
+ *  Together with the pass-through loop in run() this merges the replayed
+ *  CCs and the incoming events into one stream sorted by frame. At equal
+ *  frames incoming events go first.
+ */
+void PluginMIDICCRecorder::sendStoredCCs(uint32_t frame) {
     struct MidiEvent cc_event;
-    bool block, start_send = false;
-    static uint32_t next_frame = 0;
-
-    const TimePosition& pos(getTimePosition());
-    uint8_t trig_pc = (uint8_t) fParams[paramTrigPC];
-    uint8_t trig_pc_chan = (uint8_t) fParams[paramTrigPCChannel];
-
-    for (uint32_t i=0; i<eventCount; ++i) {
-        block = false;
-        status = events[i].data[0] & 0xF0;
-
-        if (events[i].frame > next_frame) {
-            next_frame = events[i].frame;
-        }
 
-        if (status >= 0xF0) {
-            writeMidiEvent(events[i]);
-            continue;
+    while (fNextFrame < frame) {
+        if ((sendChannel == 0 || sendChannel == curChan + 1) &&
+            stateCC[curChan][curCC] != 0xFF)
+        {
+            cc_event.frame = fNextFrame;
+            cc_event.size = 3;
+            cc_event.data[0] = MIDI_CONTROL_CHANGE | (curChan & 0xF);
+            cc_event.data[1] = curCC & 0x7F;
+            cc_event.data[2] = stateCC[curChan][curCC] & 0x7F;
+
+            // pause sending for this block if the event had to be queued
+            if (!emit(cc_event))
+                fSendPaused = true;
+
+            fNextFrame += fSendInterval;
         }
 
-        if (status < 0xF0) {
-            chan = events[i].data[0] & 0x0F;
+        curCC++;
 
-            if (status == MIDI_CONTROL_CHANGE) {
-                if (sendInProgress && (sendChannel == 0 || sendChannel == chan + 1))
-                    block = true;
+        if (curCC >= NUM_CONTROLLERS) {
+            curCC = 0;
+            curChan++;
 
-                if (fParams[paramRecordEnable] && ! sendInProgress) {
-                    cc = events[i].data[1] & 0x7F;
-                    stateCC[chan][cc] = events[i].data[2] & 0x7F;
-                }
-            }
-            else if (status == MIDI_PROGRAM_CHANGE &&
-                     (trig_pc_chan == 0 || trig_pc_chan == chan + 1) &&
-                      events[i].data[1] == trig_pc) {
-                // trigger start of sending after MIDI events have been handled
-                start_send = true;
+            if (curChan >= NUM_CHANNELS) {
+                curChan = 0;
+                sendInProgress = false;
+                fNextFrame = 0;
+                break;
             }
         }
 
-        if (!block) writeMidiEvent(events[i]);
+        if (fSendPaused)
+            break;
     }
+}
+
+
+void PluginMIDICCRecorder::run(const float**, float**, uint32_t nframes,
+                               const MidiEvent* events, uint32_t eventCount) {
+    RealtimeScope realtime;
+    RunTimerScope timing(fRunTimer);
+    const TimePosition& pos(getTimePosition());
+
+    MIDI_PROBE1(run_entry, eventCount);
+    fCounters.beginBlock(events, eventCount);
+
+    // write events the host did not accept in the last block first
+    if (!fOverflow.isEmpty())
+        fOverflow.flush([this](const MidiEvent& ev) { return writeMidiEvent(ev); });
+
+    fSendPaused = false;
+    runCommands(nframes);
 
     if (pos.playing and !playing) {
         playing = true;
@@ -446,47 +493,50 @@ void PluginMIDICCRecorder::run(const float**, float**, uint32_t nframes,
         playing = false;
     }
 
-    if (start_send) {
-        startSend();
-    }
+    dispatchMidiEvents(fClassifier, events, eventCount,
+        [this](const MidiEvent* run, uint32_t count) {
+            for (uint32_t i=0; i<count; ++i) {
+                sendUntil(run[i].frame);
+                emit(run[i]);
+            }
+        },
+        [this](const MidiEvent& event) {
+            uint8_t chan = event.data[0] & 0x0F;
 
-    if (sendInProgress) {
-        bool sendOk = true;
+            sendUntil(event.frame);
 
-        do {
-            if (next_frame >= nframes) {
-                next_frame -= nframes;
-                break;
-            }
+            if ((event.data[0] & 0xF0) == MIDI_CONTROL_CHANGE) {
+                if (sendInProgress && (sendChannel == 0 || sendChannel == chan + 1))
+                    return;
 
-            if ((sendChannel == 0 || sendChannel == curChan + 1) &&
-                stateCC[curChan][curCC] != 0xFF)
-            {
-                cc_event.frame = next_frame;
-                cc_event.size = 3;
-                cc_event.data[0] = MIDI_CONTROL_CHANGE | (curChan & 0xF);
-                cc_event.data[1] = curCC & 0x7F;
-                cc_event.data[2] = stateCC[curChan][curCC] & 0x7F;
-                sendOk = writeMidiEvent(cc_event);
-                next_frame += cc_event.frame + (int) (fSampleRate / 1000 * fParams[paramSendInterval]);
-            }
+                if (fParams[paramRecordEnable] && ! sendInProgress) {
+                    uint8_t cc = event.data[1] & 0x7F;
+                    stateCC[chan][cc] = event.data[2] & 0x7F;
+                }
 
-            curCC++;
+                emit(event);
+            }
+            else {
+                const uint8_t trig_pc = (uint8_t) fParams[paramTrigPC];
+                const uint8_t trig_pc_chan = (uint8_t) fParams[paramTrigPCChannel];
 
-            if (curCC >= NUM_CONTROLLERS) {
-                curCC = 0;
-                curChan++;
+                emit(event);
 
-                if (curChan >= NUM_CHANNELS) {
-                    curChan = 0;
-                    sendInProgress = false;
-                    next_frame = 0;
-                    break;
-                }
+                // start sending right after the triggering program change
+                if ((trig_pc_chan == 0 || trig_pc_chan == chan + 1) &&
+                    event.data[1] == trig_pc)
+                    startSend(event.frame);
             }
+        });
 
-        } while (sendOk);
-    }
+    sendUntil(nframes);
+
+    // carry the send schedule over into the next block
+    if (sendInProgress)
+        fNextFrame = fNextFrame >= nframes ? fNextFrame - nframes : 0;
+
+    fCounters.publish(fOverflow.getDroppedCount(), fOverflow.getDeferredCount());
+    MIDI_PROBE1(run_exit, eventCount);
 }
 
 // -----------------------------------------------------------------------
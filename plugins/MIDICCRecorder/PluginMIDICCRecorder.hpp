@@ -28,30 +28,17 @@
 #define PLUGIN_MIDICCRECORDER_H
 
 #include "DistrhoPlugin.hpp"
+#include "MIDICommandQueue.hpp"
+#include "MIDIEventClassifier.hpp"
+#include "MIDIEventCounters.hpp"
+#include "MIDIOverflowRing.hpp"
+#include "MIDIProbes.hpp"
+#include "MIDIRealtimeCheck.hpp"
+#include "MIDIRunTimer.hpp"
+#include "MIDIUtils.hpp"
 
 START_NAMESPACE_DISTRHO
 
-#ifndef MAP
-#define MAP(v, imin, imax, omin, omax) (((v) - (imin)) * ((omax) - (omin)) / ((imax) - (imin)) + (omin))
-#endif
-
-#ifndef MIN
-#define MIN(a,b) ( (a) < (b) ? (a) : (b) )
-#endif
-
-#ifndef MAX
-#define MAX(a,b) ( (a) > (b) ? (a) : (b) )
-#endif
-
-#ifndef CLAMP
-#define CLAMP(v, min, max) (MIN((max), MAX((min), (v))))
-#endif
-
-#define MIDI_CONTROL_CHANGE 0xB0
-#define MIDI_PROGRAM_CHANGE 0xC0
-#define NUM_CHANNELS 16
-#define NUM_CONTROLLERS 128
-
 // -----------------------------------------------------------------------
 
 class PluginMIDICCRecorder : public Plugin {
@@ -134,18 +121,48 @@ protected:
     // Process
 
     void activate() override;
-    void startSend();
+    void startSend(uint32_t frame = 0);
     void run(const float**, float**, uint32_t,
              const MidiEvent* midiEvents, uint32_t midiEventCount) override;
 
     // -------------------------------------------------------------------
 
 private:
+    // Actions of trigger parameters, carried out in run()
+    enum Commands {
+        cmdClear,
+        cmdSend
+    };
+
+    void updateSendInterval();
+    void runCommands(uint32_t nframes);
+    void sendStoredCCs(uint32_t frame);
+
+    inline void sendUntil(uint32_t frame) {
+        if (sendInProgress && !fSendPaused)
+            sendStoredCCs(frame);
+    }
+
+    inline bool emit(const MidiEvent& event) {
+        fCounters.countOutput(event);
+        return fOverflow.write(event, [this](const MidiEvent& ev) { return writeMidiEvent(ev); });
+    }
+
     float fParams[paramCount];
     double fSampleRate;
     uint8_t stateCC[NUM_CHANNELS][NUM_CONTROLLERS];
     uint8_t curChan, curCC, sendChannel;
-    bool playing, sendInProgress;
+    bool playing, sendInProgress, fSendPaused;
+    uint32_t fNextFrame, fSendInterval;
+    MidiEventClassifier fClassifier;
+    MidiOverflowRing fOverflow;
+    MidiCommandQueue fCommands;
+    MidiEventCounters fCounters;
+    RunTimer fRunTimer;
+
+    // keep the data written in run() off the cache line of the next
+    // allocation, which may be another instance processed by another thread
+    char fPadding[CACHE_LINE_SIZE];
 
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginMIDICCRecorder)
 };
@@ -155,7 +172,7 @@ struct Preset {
     float params[PluginMIDICCRecorder::paramCount];
 };
 
-Preset factoryPresets[] = {
+const Preset factoryPresets[] = {
     {
         "Default",
         {0, 0, 0, 0, 17, 0, 0, 1.0}
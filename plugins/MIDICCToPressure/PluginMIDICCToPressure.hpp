@@ -28,35 +28,15 @@
 #define PLUGIN_MIDICCTOPRESSURE_H
 
 #include "DistrhoPlugin.hpp"
+#include "MIDICCToPressureProcessor.hpp"
+#include "MIDIProcessorPlugin.hpp"
 
 START_NAMESPACE_DISTRHO
 
-#ifndef MIN
-#define MIN(a,b) ( (a) < (b) ? (a) : (b) )
-#endif
-
-#ifndef MAX
-#define MAX(a,b) ( (a) > (b) ? (a) : (b) )
-#endif
-
-#ifndef CLAMP
-#define CLAMP(v, min, max) (MIN((max), MAX((min), (v))))
-#endif
-
-#define MIDI_CONTROL_CHANGE 0xB0
-#define MIDI_CHANNEL_PRESSURE 0xD0
-
 // -----------------------------------------------------------------------
 
-class PluginMIDICCToPressure : public Plugin {
+class PluginMIDICCToPressure : public MidiProcessorPlugin<MidiCCToPressureProcessor> {
 public:
-    enum Parameters {
-        paramFilterChannel,
-        paramKeepOriginal,
-        paramSrcCC,
-        paramCount
-    };
-
     PluginMIDICCToPressure();
 
 protected:
@@ -99,14 +79,11 @@ protected:
     // -------------------------------------------------------------------
     // Init
 
-    void initParameter(uint32_t index, Parameter& parameter) override;
     void initProgramName(uint32_t index, String& programName) override;
 
     // -------------------------------------------------------------------
     // Internal data
 
-    float getParameterValue(uint32_t index) const override;
-    void setParameterValue(uint32_t index, float value) override;
     void loadProgram(uint32_t index) override;
 
     // -------------------------------------------------------------------
@@ -120,16 +97,9 @@ protected:
 
     void activate() override;
 
-    void run(const float**, float**, uint32_t,
-             const MidiEvent* midiEvents, uint32_t midiEventCount) override;
-
-
     // -------------------------------------------------------------------
 
 private:
-    float fParams[paramCount];
-    int8_t filterChannel;
-
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginMIDICCToPressure)
 };
 
@@ -0,0 +1,244 @@
+/*
+ * MIDI Chain plugin based on DISTRHO Plugin Framework (DPF)
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PluginMIDIChain.hpp"
+
+START_NAMESPACE_DISTRHO
+
+struct StageInfo {
+    const char* name;
+    const char* symbol;
+};
+
+static const StageInfo stageInfo[PluginMIDIChain::stageCount] = {
+    {"Sys Filter", "sysfilter"},
+    {"Pressure to CC", "pressuretocc"},
+    {"PB to CC", "pbtocc"},
+    {"CC Map X4", "ccmapx4"},
+    {"CC to Pressure", "cctopressure"}
+};
+
+// -----------------------------------------------------------------------
+
+PluginMIDIChain::PluginMIDIChain()
+    : Plugin(paramCount, 0, 0)  // 0 programs, 0 states
+{
+    fStages[stageSysFilter] = &fSysFilter;
+    fStages[stagePressureToCC] = &fPressureToCC;
+    fStages[stagePBToCC] = &fPBToCC;
+    fStages[stageCCMapX4] = &fCCMapX4;
+    fStages[stageCCToPressure] = &fCCToPressure;
+
+    uint32_t offset = paramStageParams;
+
+    for (uint32_t stage=0; stage < stageCount; stage++) {
+        fStageParamOffset[stage] = offset;
+        fStageEnabled[stage] = false;
+        offset += fStages[stage]->getParameterCount();
+    }
+}
+
+// -----------------------------------------------------------------------
+// Init
+
+void PluginMIDIChain::initParameter(uint32_t index, Parameter& parameter) {
+    uint32_t stage, stageIndex;
+
+    if (index >= paramCount)
+        return;
+
+    if (index < paramStageParams) {
+        parameter.hints = kParameterIsAutomable | kParameterIsInteger | kParameterIsBoolean;
+        parameter.name = String("Enable ") + stageInfo[index].name;
+        parameter.shortName = "Enable";
+        parameter.symbol = String(stageInfo[index].symbol) + "_enable";
+        parameter.ranges.def = 0;
+        parameter.ranges.min = 0;
+        parameter.ranges.max = 1;
+        parameter.group = index;
+    }
+    else if (findStageParameter(index, stage, stageIndex)) {
+        fStages[stage]->initParameter(stageIndex, parameter);
+        // Stage parameters share names and symbols, so prefix them
+        parameter.name = String(stageInfo[stage].name) + ": " + parameter.name;
+        parameter.symbol = String(stageInfo[stage].symbol) + "_" + parameter.symbol;
+        parameter.group = stage;
+    }
+    else {
+        MidiEventCounters::initParameter(index - paramCounters, parameter);
+    }
+}
+
+/**
+  Set the name and symbol of the port group @a index.
+  There is one port group for each stage.
+*/
+void PluginMIDIChain::initPortGroup(uint32_t index, PortGroup& pgroup) {
+    if (index < stageCount) {
+        pgroup.name = stageInfo[index].name;
+        pgroup.symbol = stageInfo[index].symbol;
+    }
+}
+
+// -----------------------------------------------------------------------
+// Internal data
+
+/**
+  Map global parameter @a index to a @a stage and the index of the parameter
+  in the stage's processor.
+*/
+bool PluginMIDIChain::findStageParameter(uint32_t index, uint32_t& stage, uint32_t& stageIndex) const {
+    if (index < paramStageParams || index >= paramCounters)
+        return false;
+
+    stage = stageCount - 1;
+
+    while (index < fStageParamOffset[stage])
+        stage--;
+
+    stageIndex = index - fStageParamOffset[stage];
+    return true;
+}
+
+/**
+  Get the current value of a parameter.
+*/
+float PluginMIDIChain::getParameterValue(uint32_t index) const {
+    uint32_t stage, stageIndex;
+
+    if (index < paramStageParams)
+        return fStageEnabled[index] ? 1.0f : 0.0f;
+
+    if (findStageParameter(index, stage, stageIndex))
+        return fStages[stage]->getParameterValue(stageIndex);
+
+    return fCounters.getValue(index - paramCounters);
+}
+
+/**
+  Change a parameter value.
+*/
+void PluginMIDIChain::setParameterValue(uint32_t index, float value) {
+    uint32_t stage, stageIndex;
+
+    if (index < paramStageParams)
+        fStageEnabled[index] = value >= 0.5f;
+    else if (findStageParameter(index, stage, stageIndex))
+        fStages[stage]->setParameterValue(stageIndex, value);
+}
+
+// -----------------------------------------------------------------------
+// Process
+
+void PluginMIDIChain::activate() {
+    // plugin is activated
+}
+
+/**
+  Run @a stage with its processor's template run(), so its per-event work
+  is bound at compile time and it can write straight to the host.
+*/
+template <class Sink>
+void PluginMIDIChain::runStage(uint32_t stage, const MidiEvent* events, uint32_t eventCount, Sink& out) {
+    switch (stage) {
+        case stageSysFilter:
+            fSysFilter.run(events, eventCount, out);
+            break;
+        case stagePressureToCC:
+            fPressureToCC.run(events, eventCount, out);
+            break;
+        case stagePBToCC:
+            fPBToCC.run(events, eventCount, out);
+            break;
+        case stageCCMapX4:
+            fCCMapX4.run(events, eventCount, out);
+            break;
+        case stageCCToPressure:
+            fCCToPressure.run(events, eventCount, out);
+            break;
+    }
+}
+
+void PluginMIDIChain::run(const float**, float**, uint32_t,
+                          const MidiEvent* events, uint32_t eventCount) {
+    RealtimeScope realtime;
+    RunTimerScope timing(fRunTimer);
+    HostOutput host(this);
+    const MidiEvent* input = events;
+    uint32_t count = eventCount;
+    uint32_t active[stageCount];
+    uint32_t numActive = 0;
+    uint8_t buffer = 0;
+
+    MIDI_PROBE1(run_entry, eventCount);
+    fCounters.beginBlock(events, eventCount);
+
+    // write events the host did not accept in the last block first
+    if (!fOverflow.isEmpty())
+        fOverflow.flush([this](const MidiEvent& ev) { return writeMidiEvent(ev); });
+
+    for (uint32_t stage=0; stage < stageCount; stage++) {
+        if (fStageEnabled[stage])
+            active[numActive++] = stage;
+    }
+
+    if (numActive == 0) {
+        for (uint32_t i=0; i<count; ++i)
+            host.write(input[i]);
+    }
+    else {
+        // ping-pong between the two buffers for all but the last stage
+        for (uint32_t i=0; i + 1 < numActive; i++) {
+            StageOutput output = {fBuffers[buffer], fCounters};
+
+            output.buffer.clear();
+            fCounters.setInput(input, count);
+            runStage(active[i], input, count, output);
+            input = output.buffer.data();
+            count = output.buffer.size();
+            buffer ^= 1;
+        }
+
+        fCounters.setInput(input, count);
+        runStage(active[numActive - 1], input, count, host);
+    }
+
+    fCounters.publish(fOverflow.getDroppedCount()
+                      + fBuffers[0].getDroppedCount()
+                      + fBuffers[1].getDroppedCount(),
+                      fOverflow.getDeferredCount());
+    MIDI_PROBE1(run_exit, eventCount);
+}
+
+// -----------------------------------------------------------------------
+
+Plugin* createPlugin() {
+    return new PluginMIDIChain();
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
@@ -0,0 +1,204 @@
+/*
+ * MIDI Chain plugin based on DISTRHO Plugin Framework (DPF)
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef PLUGIN_MIDICHAIN_H
+#define PLUGIN_MIDICHAIN_H
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIEventCounters.hpp"
+#include "MIDIOverflowRing.hpp"
+#include "MIDIProbes.hpp"
+#include "MIDIRealtimeCheck.hpp"
+#include "MIDIProcessor.hpp"
+#include "MIDIRunTimer.hpp"
+#include "MIDIUtils.hpp"
+
+#include "../MIDISysFilter/MIDISysFilterProcessor.hpp"
+#include "../MIDIPressureToCC/MIDIPressureToCCProcessor.hpp"
+#include "../MIDIPBToCC/MIDIPBToCCProcessor.hpp"
+#include "../MIDICCMapX4/MIDICCMapX4Processor.hpp"
+#include "../MIDICCToPressure/MIDICCToPressureProcessor.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Runs the processors of several midiomatic plugins in one instance.
+
+  The stages have a fixed order and each can be enabled separately. Events
+  pass from one enabled stage to the next through two preallocated buffers,
+  which are used alternately, and the last enabled stage writes to the host
+  directly. Disabled stages cost nothing.
+*/
+class PluginMIDIChain : public Plugin {
+public:
+    enum Stages {
+        stageSysFilter,
+        stagePressureToCC,
+        stagePBToCC,
+        stageCCMapX4,
+        stageCCToPressure,
+        stageCount
+    };
+
+    // The "enable" parameters of all stages come first, followed by the
+    // parameters of each stage's processor in stage order and the event
+    // counters.
+    enum Parameters {
+        paramSysFilterEnable,
+        paramPressureToCCEnable,
+        paramPBToCCEnable,
+        paramCCMapX4Enable,
+        paramCCToPressureEnable,
+        paramStageParams,
+        paramCounters = paramStageParams
+            + MidiSysFilterProcessor::paramCount
+            + MidiPressureToCCProcessor::paramCount
+            + MidiPBToCCProcessor::paramCount
+            + MidiCCMapX4Processor::paramCount
+            + MidiCCToPressureProcessor::paramCount,
+        paramCount = paramCounters + MidiEventCounters::kCount
+    };
+
+    PluginMIDIChain();
+
+protected:
+    // -------------------------------------------------------------------
+    // Information
+
+    const char* getLabel() const noexcept override {
+        return "MIDIChain";
+    }
+
+    const char* getDescription() const override {
+        return "Run several midiomatic MIDI processors in one plugin";
+    }
+
+    const char* getMaker() const noexcept override {
+        return "chrisarndt.de";
+    }
+
+    const char* getHomePage() const override {
+        return DISTRHO_PLUGIN_URI;
+    }
+
+    const char* getLicense() const noexcept override {
+        return "https://spdx.org/licenses/MIT";
+    }
+
+    uint32_t getVersion() const noexcept override {
+        return d_version(0, 1, 0);
+    }
+
+    // Go to:
+    //
+    // http://service.steinberg.de/databases/plugin.nsf/plugIn
+    //
+    // Get a proper plugin UID and fill it in here!
+    int64_t getUniqueId() const noexcept override {
+        return d_cconst('M', 'C', 'h', 'n');
+    }
+
+    // -------------------------------------------------------------------
+    // Init
+
+    void initParameter(uint32_t index, Parameter& parameter) override;
+    void initPortGroup(uint32_t index, PortGroup& pgroup) override;
+
+    // -------------------------------------------------------------------
+    // Internal data
+
+    float getParameterValue(uint32_t index) const override;
+    void setParameterValue(uint32_t index, float value) override;
+
+    // -------------------------------------------------------------------
+    // Process
+
+    void activate() override;
+
+    void run(const float**, float**, uint32_t,
+             const MidiEvent* midiEvents, uint32_t midiEventCount) override;
+
+    // -------------------------------------------------------------------
+
+private:
+    struct HostOutput {
+        PluginMIDIChain* const plugin;
+
+        explicit HostOutput(PluginMIDIChain* p) noexcept
+            : plugin(p) {}
+
+        inline bool write(const MidiEvent& event) {
+            plugin->fCounters.countOutput(event);
+            return plugin->fOverflow.write(event, [this](const MidiEvent& ev) {
+                return plugin->writeMidiEvent(ev);
+            });
+        }
+    };
+
+    // Output of all but the last stage
+    struct StageOutput {
+        MidiEventBuffer& buffer;
+        MidiEventCounters& counters;
+
+        inline bool write(const MidiEvent& event) {
+            counters.countGenerated(event);
+            return buffer.write(event);
+        }
+    };
+
+    bool findStageParameter(uint32_t index, uint32_t& stage, uint32_t& stageIndex) const;
+
+    template <class Sink>
+    void runStage(uint32_t stage, const MidiEvent* events, uint32_t eventCount, Sink& out);
+
+    MidiSysFilterProcessor fSysFilter;
+    MidiPressureToCCProcessor fPressureToCC;
+    MidiPBToCCProcessor fPBToCC;
+    MidiCCMapX4Processor fCCMapX4;
+    MidiCCToPressureProcessor fCCToPressure;
+
+    MidiProcessor* fStages[stageCount];
+    uint32_t fStageParamOffset[stageCount];
+    bool fStageEnabled[stageCount];
+    MidiEventBuffer fBuffers[2];
+    MidiOverflowRing fOverflow;
+    MidiEventCounters fCounters;
+    RunTimer fRunTimer;
+
+    // keep the data written in run() off the cache line of the next
+    // allocation, which may be another instance processed by another thread
+    char fPadding[CACHE_LINE_SIZE];
+
+    DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginMIDIChain)
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef PLUGIN_MIDICHAIN_H
@@ -0,0 +1,239 @@
+/*
+ * MIDI PBToCC processor, shared by the plugin and the MIDI Chain
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2019 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_PBTOCC_PROCESSOR_H
+#define MIDI_PBTOCC_PROCESSOR_H
+
+#include "DistrhoPlugin.hpp"
+#include "MIDITransformProcessor.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+// Settings derived from the parameters, see MidiTransformProcessor
+struct MidiPBToCCConfig {
+    int16_t pbMin, pbMax;
+    uint8_t ccPos, ccNeg;
+    // input and output ranges of the value mapping for positive and negative PB values
+    int16_t posStart, posEnd, negStart, negEnd;
+    uint8_t posMin, posMax, negMin, negMax;
+};
+
+class MidiPBToCCProcessor : public MidiTransformProcessor<MidiPBToCCProcessor, MidiPBToCCConfig> {
+public:
+    enum Parameters {
+        paramFilterChannel,
+        paramKeepOriginal,
+        paramPBMin,
+        paramPBMax,
+        paramCC1,
+        paramCC1Min,
+        paramCC1Max,
+        paramCC2,
+        paramCC2Min,
+        paramCC2Max,
+        paramCount
+    };
+
+    MidiPBToCCProcessor()
+        : MidiTransformProcessor(MIDI_PITCH_BEND),
+          fParams()
+    {
+        loadDefaults();
+    }
+
+    uint32_t getParameterCount() const override {
+        return paramCount;
+    }
+
+    void initParameter(uint32_t index, Parameter& parameter) const override {
+        if (index >= paramCount)
+            return;
+
+        parameter.hints = kParameterIsAutomable | kParameterIsInteger;
+        parameter.ranges.def = 0;
+        parameter.ranges.min = 0;
+        parameter.ranges.max = 127;
+
+        switch (index) {
+            case paramFilterChannel:
+                initFilterChannelParameter(parameter);
+                break;
+            case paramKeepOriginal:
+                initKeepOriginalParameter(parameter, "Keep original PB events", "Keep PB");
+                break;
+            case paramPBMin:
+                parameter.name = "PB min. value";
+                parameter.symbol = "pb_min";
+                parameter.ranges.def = -8192;
+                parameter.ranges.min = -8192;
+                parameter.ranges.max = 8191;
+                break;
+            case paramPBMax:
+                parameter.name = "PB max. value";
+                parameter.symbol = "pb_max";
+                parameter.ranges.def = 8191;
+                parameter.ranges.min = -8192;
+                parameter.ranges.max = 8191;
+                break;
+            case paramCC1:
+                parameter.name = "Pos. PB -> CC A";
+                parameter.symbol = "cc1";
+                parameter.ranges.def = 1;
+                break;
+            case paramCC1Min:
+                parameter.name = "CC A min. value";
+                parameter.symbol = "cc1_min";
+                break;
+            case paramCC1Max:
+                parameter.name = "CC A max. value";
+                parameter.symbol = "cc1_max";
+                parameter.ranges.def = 127;
+                break;
+            case paramCC2:
+                parameter.name = "Neg. PB -> CC B";
+                parameter.symbol = "cc2";
+                parameter.ranges.def = 1;
+                break;
+            case paramCC2Min:
+                parameter.name = "CC B min. value";
+                parameter.symbol = "cc2_min";
+                break;
+            case paramCC2Max:
+                parameter.name = "CC B max. value";
+                parameter.symbol = "cc2_max";
+                parameter.ranges.def = 127;
+                break;
+       }
+    }
+
+    float getParameterValue(uint32_t index) const override {
+        return fParams[index];
+    }
+
+private:
+    friend class MidiTransformProcessor<MidiPBToCCProcessor, MidiPBToCCConfig>;
+
+    void storeParameter(uint32_t index, float value) {
+        switch (index) {
+            case paramFilterChannel:
+                fParams[index] = setFilterChannel(value);
+                break;
+            case paramKeepOriginal:
+                fParams[index] = setKeepOriginal(value);
+                break;
+            case paramPBMin:
+            case paramPBMax:
+                fParams[index] = clamp(value, -8192.0f, 8191.0f);
+                break;
+            case paramCC1:
+            case paramCC2:
+            case paramCC1Min:
+            case paramCC1Max:
+            case paramCC2Min:
+            case paramCC2Max:
+                fParams[index] = clamp(value, 0.0f, 127.0f);
+                break;
+        }
+    }
+
+    /**
+      Set up the PB input range, the destination controllers and the value
+      mapping for positive and negative PB values, so the per-event work needs
+      no parameter casts.
+    */
+    bool updateConfig(MidiPBToCCConfig& config) const {
+        const int16_t pb_min = (int16_t) fParams[paramPBMin],
+                      pb_max = (int16_t) fParams[paramPBMax];
+        const uint8_t cc1_min = (uint8_t) fParams[paramCC1Min],
+                      cc1_max = (uint8_t) fParams[paramCC1Max],
+                      cc2_min = (uint8_t) fParams[paramCC2Min],
+                      cc2_max = (uint8_t) fParams[paramCC2Max];
+
+        config.pbMin = pb_min;
+        config.pbMax = pb_max;
+
+        if (pb_min <= pb_max) {
+            // convert values in pb_min .. pb_max
+            config.posStart = 0;
+            config.posEnd = pb_max;
+            config.negStart = -1;
+            config.negEnd = pb_min;
+        }
+        else {
+            // convert values outside of pb_max + 1 .. pb_min - 1
+            config.posStart = pb_min;
+            config.posEnd = 8191;
+            config.negStart = pb_max;
+            config.negEnd = -8192;
+        }
+
+        config.posMin = cc1_min;
+        config.posMax = cc1_max;
+        config.negMin = cc2_min;
+        config.negMax = cc2_max;
+
+        config.ccPos = (uint8_t) fParams[paramCC1];
+        config.ccNeg = (uint8_t) fParams[paramCC2];
+        return true;
+    }
+
+    template <class Sink>
+    inline bool transform(const MidiEvent& event, const MidiPBToCCConfig& config, Sink& out) {
+        struct MidiEvent cc_event;
+        int16_t pb_value = (((event.data[2] & 0x7f) << 7) | (event.data[1] & 0x7f)) - 8192;
+
+        if (!inRange(pb_value, config.pbMin, config.pbMax))
+            return false;
+
+        cc_event.frame = event.frame;
+        cc_event.size = 3;
+        cc_event.data[0] = MIDI_CONTROL_CHANGE | (event.data[0] & 0x0F);
+
+        if (pb_value >= 0) {
+            cc_event.data[1] = config.ccPos;
+            cc_event.data[2] = ((uint8_t) mapRange<int32_t>(pb_value, config.posStart, config.posEnd,
+                                                            config.posMin, config.posMax)) & 0x7f;
+        }
+        else {
+            cc_event.data[1] = config.ccNeg;
+            cc_event.data[2] = ((uint8_t) mapRange<int32_t>(pb_value, config.negStart, config.negEnd,
+                                                            config.negMin, config.negMax)) & 0x7f;
+        }
+
+        out.write(cc_event);
+        return true;
+    }
+
+    float fParams[paramCount];
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_PBTOCC_PROCESSOR_H
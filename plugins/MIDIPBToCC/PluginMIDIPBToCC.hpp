@@ -28,50 +28,15 @@
 #define PLUGIN_MIDIPBTOCC_H
 
 #include "DistrhoPlugin.hpp"
+#include "MIDIPBToCCProcessor.hpp"
+#include "MIDIProcessorPlugin.hpp"
 
 START_NAMESPACE_DISTRHO
 
-#ifndef IN_RANGE
-#define IN_RANGE(v, min, max) ((min) <= (max) ? ((v) >= (min) && (v) <= (max)) : ((v) >= (min) || (v) <= (max)))
-#endif
-
-#ifndef MAP
-#define MAP(v, imin, imax, omin, omax) (((v) - (imin)) * ((omax) - (omin)) / ((imax) - (imin)) + (omin))
-#endif
-
-#ifndef MIN
-#define MIN(a,b) ( (a) < (b) ? (a) : (b) )
-#endif
-
-#ifndef MAX
-#define MAX(a,b) ( (a) > (b) ? (a) : (b) )
-#endif
-
-#ifndef CLAMP
-#define CLAMP(v, min, max) (MIN((max), MAX((min), (v))))
-#endif
-
-#define MIDI_CONTROL_CHANGE 0xB0
-#define MIDI_PITCH_BEND 0xE0
-
 // -----------------------------------------------------------------------
 
-class PluginMIDIPBToCC : public Plugin {
+class PluginMIDIPBToCC : public MidiProcessorPlugin<MidiPBToCCProcessor> {
 public:
-    enum Parameters {
-        paramFilterChannel,
-        paramKeepOriginal,
-        paramPBMin,
-        paramPBMax,
-        paramCC1,
-        paramCC1Min,
-        paramCC1Max,
-        paramCC2,
-        paramCC2Min,
-        paramCC2Max,
-        paramCount
-    };
-
     PluginMIDIPBToCC();
 
 protected:
@@ -114,14 +79,11 @@ protected:
     // -------------------------------------------------------------------
     // Init
 
-    void initParameter(uint32_t index, Parameter& parameter) override;
     void initProgramName(uint32_t index, String& programName) override;
 
     // -------------------------------------------------------------------
     // Internal data
 
-    float getParameterValue(uint32_t index) const override;
-    void setParameterValue(uint32_t index, float value) override;
     void loadProgram(uint32_t index) override;
 
     // -------------------------------------------------------------------
@@ -135,16 +97,9 @@ protected:
 
     void activate() override;
 
-    void run(const float**, float**, uint32_t,
-             const MidiEvent* midiEvents, uint32_t midiEventCount) override;
-
-
     // -------------------------------------------------------------------
 
 private:
-    float fParams[paramCount];
-    int8_t filterChannel;
-
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginMIDIPBToCC)
 };
 
@@ -0,0 +1,132 @@
+/*
+ * MIDI PressureToCC processor, shared by the plugin and the MIDI Chain
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2020 Christopher Arndt <info@chrisarndt.de>, Jorik Jonker <jorik@kippendief.biz>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_PRESSURETOCC_PROCESSOR_H
+#define MIDI_PRESSURETOCC_PROCESSOR_H
+
+#include "DistrhoPlugin.hpp"
+#include "MIDITransformProcessor.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+// Settings derived from the parameters, see MidiTransformProcessor
+struct MidiPressureToCCConfig {
+    uint8_t destCC;
+};
+
+class MidiPressureToCCProcessor : public MidiTransformProcessor<MidiPressureToCCProcessor, MidiPressureToCCConfig> {
+public:
+    enum Parameters {
+        paramFilterChannel,
+        paramKeepOriginal,
+        paramDestCC,
+        paramCount
+    };
+
+    MidiPressureToCCProcessor()
+        : MidiTransformProcessor(MIDI_CHANNEL_PRESSURE),
+          fParams()
+    {
+        loadDefaults();
+    }
+
+    uint32_t getParameterCount() const override {
+        return paramCount;
+    }
+
+    void initParameter(uint32_t index, Parameter& parameter) const override {
+        if (index >= paramCount)
+            return;
+
+        parameter.hints = kParameterIsAutomable | kParameterIsInteger;
+        parameter.ranges.def = 0;
+        parameter.ranges.min = 0;
+        parameter.ranges.max = 127;
+
+        switch (index) {
+            case paramFilterChannel:
+                initFilterChannelParameter(parameter);
+                break;
+            case paramKeepOriginal:
+                initKeepOriginalParameter(parameter, "Keep original Pressure events", "Keep original");
+                break;
+            case paramDestCC:
+                parameter.name = "Destination CC";
+                parameter.symbol = "dest_cc";
+                parameter.ranges.def = 1;
+                break;
+       }
+    }
+
+    float getParameterValue(uint32_t index) const override {
+        return fParams[index];
+    }
+
+private:
+    friend class MidiTransformProcessor<MidiPressureToCCProcessor, MidiPressureToCCConfig>;
+
+    void storeParameter(uint32_t index, float value) {
+        switch (index) {
+            case paramFilterChannel:
+                fParams[index] = setFilterChannel(value);
+                break;
+            case paramKeepOriginal:
+                fParams[index] = setKeepOriginal(value);
+                break;
+            case paramDestCC:
+                fParams[index] = clamp(value, 0.0f, 127.0f);
+                break;
+        }
+    }
+
+    bool updateConfig(MidiPressureToCCConfig& config) const {
+        config.destCC = (uint8_t) fParams[paramDestCC];
+        return true;
+    }
+
+    template <class Sink>
+    inline bool transform(const MidiEvent& event, const MidiPressureToCCConfig& config, Sink& out) {
+        struct MidiEvent cc_event;
+
+        cc_event.frame = event.frame;
+        cc_event.size = 3;
+        cc_event.data[0] = MIDI_CONTROL_CHANGE | (event.data[0] & 0x0F);
+        cc_event.data[1] = config.destCC;
+        cc_event.data[2] = event.data[1] & 0x7f;
+        out.write(cc_event);
+        return true;
+    }
+
+    float fParams[paramCount];
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_PRESSURETOCC_PROCESSOR_H
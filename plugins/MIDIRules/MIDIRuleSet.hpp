@@ -0,0 +1,507 @@
+/*
+ * Compiled MIDI rule set for the MIDI Rules plugin
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_RULE_SET_H
+#define MIDI_RULE_SET_H
+
+#include <cstdlib>
+#include <cstring>
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIUtils.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  A set of MIDI event rules, compiled into a status-indexed dispatch table.
+
+  Rules are given as text, one per line (or separated by ';'), '#' starts
+  a comment:
+
+      <type>[/<channel>] [<data1 range> [<data2 range>]] : <action>
+
+  <type> is one of noteoff, noteon, polypressure, cc, pc, pressure or pb,
+  <channel> is 1-16 (any channel if omitted) and a range is "N" or "N-M"
+  (0-127). If N > M, the range matches values outside of M .. N. The action
+  is one of:
+
+      drop
+      map <type>[/<channel>] [<value1> [<value2>]]
+      emit <type>[/<channel>] [<value1> [<value2>]]
+
+  "map" replaces the event with a new one, "emit" sends a new event in
+  addition to the original. The new event has the source channel unless one
+  is given. A value is a number, "d1" or "d2" for a data byte of the source
+  event, or "d1>N-M" / "d2>N-M" to scale that data byte from its match range
+  to N .. M. Omitted values default to d1 and d2.
+
+  Rules are evaluated in order. The first matching "drop" or "map" rule ends
+  the evaluation, "emit" rules do not, so one event can trigger several.
+  Events not matched by a "drop" or "map" rule are passed through. At most
+  kMaxEmits "emit" rules may match any one type and channel, further ones
+  are rejected as invalid. So the events generated per input event, and with
+  them the cost of a block, are bounded independently of the rules.
+
+  Examples:
+
+      cc 7 : map cc 11              # CC 7 -> CC 11 on the same channel
+      noteon/10 36 : emit pc/10 5   # Note 36 on ch. 10 also sends PC 5
+      cc 1 : map cc 1 d2>127-0      # invert the Modulation wheel
+      pc : drop
+
+  compile() is meant to be called outside of the realtime thread. The
+  evaluation in run() only looks up the candidate rules for the event's status
+  byte in the dispatch table and checks their data ranges in flat arrays.
+*/
+class MidiRuleSet {
+public:
+    static constexpr uint32_t kMaxRules = 128;
+    static constexpr uint32_t kMaxEntries = kMaxRules * NUM_CHANNELS;
+    static constexpr uint32_t kMaxEmits = 8;
+
+    MidiRuleSet() noexcept
+        : fNumRules(0),
+          fNumErrors(0)
+    {
+        std::memset(fFirst, 0, sizeof(fFirst));
+        std::memset(fCount, 0, sizeof(fCount));
+        std::memset(fNumEmits, 0, sizeof(fNumEmits));
+    }
+
+    uint32_t getRuleCount() const noexcept {
+        return fNumRules;
+    }
+
+    /**
+      Number of lines, which could not be parsed or had too many "emit" rules
+      for their type and channel, and were ignored.
+    */
+    uint32_t getErrorCount() const noexcept {
+        return fNumErrors;
+    }
+
+    /**
+      Parse the rules in @a text and build the dispatch table.
+      Invalid rules are skipped and counted.
+    */
+    void compile(const char* text) {
+        char line[256];
+
+        fNumRules = 0;
+        fNumErrors = 0;
+        std::memset(fNumEmits, 0, sizeof(fNumEmits));
+
+        while (*text) {
+            size_t len = std::strcspn(text, "\n;");
+
+            if (len < sizeof(line)) {
+                std::memcpy(line, text, len);
+                line[len] = '\0';
+
+                if (char* comment = std::strchr(line, '#'))
+                    *comment = '\0';
+
+                if (!isBlank(line) && !parseRule(line))
+                    fNumErrors++;
+            }
+            else {
+                fNumErrors++;
+            }
+
+            text += len;
+
+            if (*text)
+                text++;
+        }
+
+        buildTable();
+    }
+
+    /**
+      Apply the rules to @a eventCount events and write the result to @a out.
+    */
+    template <class Sink>
+    void run(const MidiEvent* events, uint32_t eventCount, Sink& out) const {
+        for (uint32_t i=0; i<eventCount; ++i) {
+            const MidiEvent& event(events[i]);
+
+            if (event.size > MidiEvent::kDataSize || event.size == 0) {
+                out.write(event);
+                continue;
+            }
+
+            const uint8_t status = event.data[0];
+            const uint16_t* entry = fEntries + fFirst[status];
+            const uint16_t* const end = entry + fCount[status];
+            const uint8_t d1 = event.size > 1 ? event.data[1] : 0;
+            const uint8_t d2 = event.size > 2 ? event.data[2] : 0;
+            bool pass = true;
+
+            for (; entry < end; ++entry) {
+                const uint16_t r = *entry;
+
+                if (!inRange(d1, fD1Min[r], fD1Max[r]) || !inRange(d2, fD2Min[r], fD2Max[r]))
+                    continue;
+
+                if (fAction[r] == kActionEmit) {
+                    out.write(makeEvent(r, event, d1, d2));
+                    continue;
+                }
+
+                if (fAction[r] == kActionMap)
+                    out.write(makeEvent(r, event, d1, d2));
+
+                pass = false;
+                break;
+            }
+
+            if (pass)
+                out.write(event);
+        }
+    }
+
+private:
+    enum Action {
+        kActionDrop,
+        kActionMap,
+        kActionEmit
+    };
+
+    enum Source {
+        kSourceConst,
+        kSourceD1,
+        kSourceD2
+    };
+
+    static constexpr uint8_t kSourceChannel = 0xFF;
+
+    // ---------------------------------------------------------------
+    // Evaluation
+
+    inline MidiEvent makeEvent(uint16_t r, const MidiEvent& event, uint8_t d1, uint8_t d2) const {
+        MidiEvent ev;
+        const uint8_t chan = fOutChannel[r] == kSourceChannel ? (event.data[0] & 0x0F) : fOutChannel[r];
+
+        ev.frame = event.frame;
+        ev.size = fOutType[r] == MIDI_PROGRAM_CHANGE || fOutType[r] == MIDI_CHANNEL_PRESSURE ? 2 : 3;
+        ev.data[0] = fOutType[r] | chan;
+        ev.data[1] = value(r, 0, d1, d2);
+        ev.data[2] = ev.size > 2 ? value(r, 1, d1, d2) : 0;
+        ev.data[3] = 0;
+        ev.dataExt = nullptr;
+        return ev;
+    }
+
+    inline uint8_t value(uint16_t r, int n, uint8_t d1, uint8_t d2) const {
+        switch (fValSource[n][r]) {
+            case kSourceD1:
+                return (uint8_t) mapValue(r, n, d1) & 0x7F;
+            case kSourceD2:
+                return (uint8_t) mapValue(r, n, d2) & 0x7F;
+            default:
+                return fValConst[n][r];
+        }
+    }
+
+    inline int32_t mapValue(uint16_t r, int n, uint8_t v) const {
+        return mapRange<int32_t>(v, fValInMin[n][r], fValInMax[n][r], fValOutMin[n][r], fValOutMax[n][r]);
+    }
+
+    // ---------------------------------------------------------------
+    // Compilation
+
+    static bool isBlank(const char* s) {
+        for (; *s; ++s) {
+            if (*s != ' ' && *s != '\t' && *s != '\r')
+                return false;
+        }
+
+        return true;
+    }
+
+    static char* nextToken(char*& s) {
+        while (*s == ' ' || *s == '\t' || *s == '\r')
+            ++s;
+
+        if (!*s)
+            return nullptr;
+
+        char* token = s;
+
+        while (*s && *s != ' ' && *s != '\t' && *s != '\r')
+            ++s;
+
+        if (*s)
+            *s++ = '\0';
+
+        return token;
+    }
+
+    static bool parseNumber(const char* s, uint8_t min, uint8_t max, uint8_t& value) {
+        char* end;
+        long v = std::strtol(s, &end, 10);
+
+        if (end == s || *end || v < min || v > max)
+            return false;
+
+        value = (uint8_t) v;
+        return true;
+    }
+
+    static bool parseRange(char* s, uint8_t& min, uint8_t& max) {
+        if (char* dash = std::strchr(s, '-')) {
+            *dash = '\0';
+            return parseNumber(s, 0, 127, min) && parseNumber(dash + 1, 0, 127, max);
+        }
+
+        if (!parseNumber(s, 0, 127, min))
+            return false;
+
+        max = min;
+        return true;
+    }
+
+    static bool parseType(char* s, uint8_t& type, uint8_t& channel) {
+        static const struct { const char* name; uint8_t type; } types[] = {
+            {"noteoff", MIDI_NOTE_OFF},
+            {"noteon", MIDI_NOTE_ON},
+            {"polypressure", MIDI_POLY_PRESSURE},
+            {"cc", MIDI_CONTROL_CHANGE},
+            {"pc", MIDI_PROGRAM_CHANGE},
+            {"pressure", MIDI_CHANNEL_PRESSURE},
+            {"pb", MIDI_PITCH_BEND}
+        };
+
+        channel = kSourceChannel;
+
+        if (char* slash = std::strchr(s, '/')) {
+            *slash = '\0';
+
+            if (!parseNumber(slash + 1, 1, 16, channel))
+                return false;
+
+            channel--;
+        }
+
+        for (size_t i=0; i < sizeof(types) / sizeof(types[0]); i++) {
+            if (std::strcmp(s, types[i].name) == 0) {
+                type = types[i].type;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool parseValue(char* s, uint16_t r, int n) {
+        uint8_t min, max;
+
+        if (s[0] != 'd' || (s[1] != '1' && s[1] != '2')) {
+            fValSource[n][r] = kSourceConst;
+            return parseNumber(s, 0, 127, fValConst[n][r]);
+        }
+
+        const bool fromD1 = s[1] == '1';
+        const uint8_t imin = fromD1 ? fD1Min[r] : fD2Min[r];
+        const uint8_t imax = fromD1 ? fD1Max[r] : fD2Max[r];
+
+        fValSource[n][r] = fromD1 ? kSourceD1 : kSourceD2;
+
+        if (s[2] == '\0') {
+            setValueMap(r, n, 0, 127, 0, 127);
+            return true;
+        }
+
+        if (s[2] != '>' || !parseRange(s + 3, min, max))
+            return false;
+
+        setValueMap(r, n, imin, imax, min, max);
+        return true;
+    }
+
+    void setValueMap(uint16_t r, int n, uint8_t imin, uint8_t imax, uint8_t omin, uint8_t omax) {
+        fValInMin[n][r] = imin;
+        fValInMax[n][r] = imax;
+        fValOutMin[n][r] = omin;
+        fValOutMax[n][r] = omax;
+    }
+
+    bool parseRule(char* line) {
+        char* colon = std::strchr(line, ':');
+        char* token;
+        uint8_t type, channel;
+
+        if (colon == nullptr || fNumRules >= kMaxRules)
+            return false;
+
+        *colon = '\0';
+
+        const uint16_t r = (uint16_t) fNumRules;
+        char* match = line;
+        char* action = colon + 1;
+
+        // match
+        if ((token = nextToken(match)) == nullptr || !parseType(token, type, channel))
+            return false;
+
+        fMatchType[r] = type;
+        fMatchChannel[r] = channel;
+        fD1Min[r] = fD2Min[r] = 0;
+        fD1Max[r] = fD2Max[r] = 127;
+
+        if ((token = nextToken(match)) != nullptr) {
+            if (!parseRange(token, fD1Min[r], fD1Max[r]))
+                return false;
+
+            if ((token = nextToken(match)) != nullptr && !parseRange(token, fD2Min[r], fD2Max[r]))
+                return false;
+
+            if (nextToken(match) != nullptr)
+                return false;
+        }
+
+        // action
+        if ((token = nextToken(action)) == nullptr)
+            return false;
+
+        if (std::strcmp(token, "drop") == 0) {
+            fAction[r] = kActionDrop;
+
+            if (nextToken(action) != nullptr)
+                return false;
+        }
+        else {
+            if (std::strcmp(token, "map") == 0)
+                fAction[r] = kActionMap;
+            else if (std::strcmp(token, "emit") == 0)
+                fAction[r] = kActionEmit;
+            else
+                return false;
+
+            if ((token = nextToken(action)) == nullptr || !parseType(token, fOutType[r], fOutChannel[r]))
+                return false;
+
+            char d1[] = "d1", d2[] = "d2";
+
+            for (int n=0; n < 2; n++) {
+                if ((token = nextToken(action)) == nullptr)
+                    token = n == 0 ? d1 : d2;
+
+                if (!parseValue(token, r, n))
+                    return false;
+            }
+
+            if (nextToken(action) != nullptr)
+                return false;
+
+            if (fAction[r] == kActionEmit && !addEmit(type, channel))
+                return false;
+        }
+
+        fNumRules++;
+        return true;
+    }
+
+    /**
+      Count an "emit" rule for events of @a type on @a channel (or any
+      channel), unless there are kMaxEmits for any of these already.
+    */
+    bool addEmit(uint8_t type, uint8_t channel) {
+        uint8_t* const counts = fNumEmits[(type >> 4) & 0x07];
+        const uint8_t first = channel == kSourceChannel ? 0 : channel;
+        const uint8_t last = channel == kSourceChannel ? NUM_CHANNELS - 1 : channel;
+
+        for (uint8_t ch=first; ch <= last; ch++) {
+            if (counts[ch] >= kMaxEmits)
+                return false;
+        }
+
+        for (uint8_t ch=first; ch <= last; ch++)
+            counts[ch]++;
+
+        return true;
+    }
+
+    /**
+      For each status byte collect the rules, which can match it, in rule
+      order. A rule for any channel is entered for all 16 status bytes of
+      its type.
+    */
+    void buildTable() {
+        uint32_t numEntries = 0;
+
+        for (uint32_t status=0; status < 256; status++) {
+            fFirst[status] = (uint16_t) numEntries;
+            fCount[status] = 0;
+
+            if (status < 0x80 || status >= 0xF0)
+                continue;
+
+            for (uint32_t r=0; r < fNumRules; r++) {
+                if (fMatchType[r] != (status & 0xF0))
+                    continue;
+
+                if (fMatchChannel[r] != kSourceChannel && fMatchChannel[r] != (status & 0x0F))
+                    continue;
+
+                fEntries[numEntries++] = (uint16_t) r;
+                fCount[status]++;
+            }
+        }
+    }
+
+    // dispatch table
+    uint16_t fFirst[256];
+    uint16_t fCount[256];
+    uint16_t fEntries[kMaxEntries];
+
+    // flat per-rule arrays
+    uint8_t fMatchType[kMaxRules];
+    uint8_t fMatchChannel[kMaxRules];
+    uint8_t fD1Min[kMaxRules], fD1Max[kMaxRules];
+    uint8_t fD2Min[kMaxRules], fD2Max[kMaxRules];
+    uint8_t fAction[kMaxRules];
+    uint8_t fOutType[kMaxRules];
+    uint8_t fOutChannel[kMaxRules];
+    uint8_t fValSource[2][kMaxRules];
+    uint8_t fValConst[2][kMaxRules];
+    uint8_t fValInMin[2][kMaxRules], fValInMax[2][kMaxRules];
+    uint8_t fValOutMin[2][kMaxRules], fValOutMax[2][kMaxRules];
+
+    // "emit" rules per type and channel, while compiling
+    uint8_t fNumEmits[8][NUM_CHANNELS];
+
+    uint32_t fNumRules;
+    uint32_t fNumErrors;
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_RULE_SET_H
@@ -0,0 +1,153 @@
+/*
+ * MIDI Rules plugin based on DISTRHO Plugin Framework (DPF)
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include "PluginMIDIRules.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+PluginMIDIRules::PluginMIDIRules()
+    : Plugin(MidiEventCounters::kCount, 0, stateCount),  // 0 programs
+      fActive(new MidiRuleSet()),
+      fPending(nullptr),
+      fRetired(nullptr) {}
+
+PluginMIDIRules::~PluginMIDIRules() {
+    delete fPending.exchange(nullptr);
+    delete fRetired.exchange(nullptr);
+    delete fActive;
+}
+
+// -----------------------------------------------------------------------
+// Init
+
+/**
+  The only parameters are the event counters.
+*/
+void PluginMIDIRules::initParameter(uint32_t index, Parameter& parameter) {
+    MidiEventCounters::initParameter(index, parameter);
+}
+
+/**
+  Set the key and default value of the state @a index.
+  This function will be called once, shortly after the plugin is created.
+*/
+void PluginMIDIRules::initState(uint32_t index, String& stateKey, String& defaultStateValue) {
+    if (index == stateRules) {
+        stateKey = "rules";
+        defaultStateValue = "";
+    }
+}
+
+// -----------------------------------------------------------------------
+// Internal data
+
+float PluginMIDIRules::getParameterValue(uint32_t index) const {
+    return fCounters.getValue(index);
+}
+
+void PluginMIDIRules::setParameterValue(uint32_t, float) {
+    // output parameters only
+}
+
+String PluginMIDIRules::getState(const char* key) const {
+    MIDI_PROBE1(state_save, key);
+
+    if (std::strcmp(key, "rules") == 0)
+        return fRules;
+
+    return String();
+}
+
+/**
+  Compile the rules given in @a value and pass them on to run().
+  Called by the host outside of the realtime thread.
+*/
+void PluginMIDIRules::setState(const char* key, const char* value) {
+    MIDI_PROBE1(state_load, key);
+
+    if (std::strcmp(key, "rules") != 0)
+        return;
+
+    MidiRuleSet* ruleSet = new MidiRuleSet();
+    ruleSet->compile(value);
+
+    if (ruleSet->getErrorCount() > 0)
+        d_stderr("MIDI Rules: ignored %u invalid rule(s).", ruleSet->getErrorCount());
+
+    fRules = value;
+
+    // Free the rule set run() has given back, if any, and replace a pending
+    // one, which run() has not picked up yet.
+    delete fRetired.exchange(nullptr, std::memory_order_acquire);
+    delete fPending.exchange(ruleSet, std::memory_order_acq_rel);
+}
+
+// -----------------------------------------------------------------------
+// Process
+
+void PluginMIDIRules::activate() {
+    // plugin is activated
+}
+
+void PluginMIDIRules::run(const float**, float**, uint32_t,
+                          const MidiEvent* events, uint32_t eventCount) {
+    RealtimeScope realtime;
+    RunTimerScope timing(fRunTimer);
+
+    MIDI_PROBE1(run_entry, eventCount);
+
+    // pick up a newly compiled rule set
+    if (fRetired.load(std::memory_order_acquire) == nullptr) {
+        if (MidiRuleSet* ruleSet = fPending.exchange(nullptr, std::memory_order_acq_rel)) {
+            fRetired.store(fActive, std::memory_order_release);
+            fActive = ruleSet;
+        }
+    }
+
+    HostOutput out(this);
+
+    fCounters.beginBlock(events, eventCount);
+
+    // write events the host did not accept in the last block first
+    if (!fOverflow.isEmpty())
+        fOverflow.flush([this](const MidiEvent& ev) { return writeMidiEvent(ev); });
+
+    fActive->run(events, eventCount, out);
+    fCounters.publish(fOverflow.getDroppedCount(), fOverflow.getDeferredCount());
+    MIDI_PROBE1(run_exit, eventCount);
+}
+
+// -----------------------------------------------------------------------
+
+Plugin* createPlugin() {
+    return new PluginMIDIRules();
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
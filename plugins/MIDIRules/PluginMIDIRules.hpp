@@ -0,0 +1,164 @@
+/*
+ * MIDI Rules plugin based on DISTRHO Plugin Framework (DPF)
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef PLUGIN_MIDIRULES_H
+#define PLUGIN_MIDIRULES_H
+
+#include <atomic>
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIEventCounters.hpp"
+#include "MIDIOverflowRing.hpp"
+#include "MIDIProbes.hpp"
+#include "MIDIRealtimeCheck.hpp"
+#include "MIDIRuleSet.hpp"
+#include "MIDIRunTimer.hpp"
+#include "MIDIUtils.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Transforms MIDI events according to a set of text rules.
+
+  The rules are stored in the plugin state "rules" (see MidiRuleSet for the
+  syntax). setState() compiles them into a new rule set and hands it to the
+  audio thread through fPending. At the start of run() the audio thread swaps
+  it in and passes the previous one back through fRetired, which is freed by
+  the next setState() call. The audio thread takes no new rule set until the
+  retired one has been collected, so it never frees or allocates memory.
+*/
+class PluginMIDIRules : public Plugin {
+public:
+    enum States {
+        stateRules,
+        stateCount
+    };
+
+    PluginMIDIRules();
+    ~PluginMIDIRules() override;
+
+protected:
+    // -------------------------------------------------------------------
+    // Information
+
+    const char* getLabel() const noexcept override {
+        return "MIDIRules";
+    }
+
+    const char* getDescription() const override {
+        return "Filter, map and generate MIDI events according to a set of rules";
+    }
+
+    const char* getMaker() const noexcept override {
+        return "chrisarndt.de";
+    }
+
+    const char* getHomePage() const override {
+        return DISTRHO_PLUGIN_URI;
+    }
+
+    const char* getLicense() const noexcept override {
+        return "https://spdx.org/licenses/MIT";
+    }
+
+    uint32_t getVersion() const noexcept override {
+        return d_version(0, 1, 0);
+    }
+
+    // Go to:
+    //
+    // http://service.steinberg.de/databases/plugin.nsf/plugIn
+    //
+    // Get a proper plugin UID and fill it in here!
+    int64_t getUniqueId() const noexcept override {
+        return d_cconst('M', 'R', 'u', 'l');
+    }
+
+    // -------------------------------------------------------------------
+    // Init
+
+    void initParameter(uint32_t index, Parameter& parameter) override;
+    void initState(uint32_t index, String& stateKey, String& defaultStateValue) override;
+
+    // -------------------------------------------------------------------
+    // Internal data
+
+    float getParameterValue(uint32_t index) const override;
+    void setParameterValue(uint32_t index, float value) override;
+    String getState(const char* key) const override;
+    void setState(const char* key, const char* value) override;
+
+    // -------------------------------------------------------------------
+    // Process
+
+    void activate() override;
+
+    void run(const float**, float**, uint32_t,
+             const MidiEvent* midiEvents, uint32_t midiEventCount) override;
+
+    // -------------------------------------------------------------------
+
+private:
+    struct HostOutput {
+        PluginMIDIRules* const plugin;
+
+        explicit HostOutput(PluginMIDIRules* p) noexcept
+            : plugin(p) {}
+
+        inline bool write(const MidiEvent& event) {
+            plugin->fCounters.countOutput(event);
+            return plugin->fOverflow.write(event, [this](const MidiEvent& ev) {
+                return plugin->writeMidiEvent(ev);
+            });
+        }
+    };
+
+    String fRules;
+
+    // only accessed by the audio thread
+    MidiRuleSet* fActive;
+    // rule sets in transit between setState() and run()
+    std::atomic<MidiRuleSet*> fPending;
+    std::atomic<MidiRuleSet*> fRetired;
+
+    MidiOverflowRing fOverflow;
+    MidiEventCounters fCounters;
+    RunTimer fRunTimer;
+
+    // keep the data written in run() off the cache line of the next
+    // allocation, which may be another instance processed by another thread
+    char fPadding[CACHE_LINE_SIZE];
+
+    DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginMIDIRules)
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef PLUGIN_MIDIRULES_H
@@ -0,0 +1,271 @@
+/*
+ * MIDI SysFilter processor, shared by the plugin and the MIDI Chain
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2019 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_SYSFILTER_PROCESSOR_H
+#define MIDI_SYSFILTER_PROCESSOR_H
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIConfigSnapshot.hpp"
+#include "MIDIEventClassifier.hpp"
+#include "MIDIProcessor.hpp"
+#include "MIDIUtils.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+const ParameterEnumerationValue paramEnumSysFilterModes[] = {
+    {0, "Block disabled events (pass all others)"},
+    {1, "Pass enabled events (block all others)"}
+};
+
+// -----------------------------------------------------------------------
+
+class MidiSysFilterProcessor : public MidiProcessor {
+public:
+    enum Parameters {
+        paramFilterMode,
+        paramSystemExclusive,
+        paramMTCQuarterFrame,
+        paramSongPositionPointer,
+        paramSongSelect,
+        paramTuneRequest,
+        paramTimingClock,
+        paramStart,
+        paramContinue,
+        paramStop,
+        paramActiveSensing,
+        paramSystemReset,
+        paramUndefined,
+        paramCount
+    };
+
+    /**
+      Start out passing all events, i.e. like the "Pass-through" program.
+    */
+    MidiSysFilterProcessor() {
+        fParams[paramFilterMode] = 0.0f;
+
+        for (int i=1; i<paramCount; i++) {
+            fParams[i] = 1.0f;
+        }
+
+        fClassifier.addMatch(MIDI_SYSTEM_EXCLUSIVE);
+        publish();
+    }
+
+    uint32_t getParameterCount() const override {
+        return paramCount;
+    }
+
+    void initParameter(uint32_t index, Parameter& parameter) const override {
+        if (index >= paramCount)
+            return;
+
+        parameter.hints = kParameterIsAutomable | kParameterIsBoolean | kParameterIsInteger;
+        parameter.ranges.def = 0.0f;
+        parameter.ranges.min = 0.0f;
+        parameter.ranges.max = 1.0f;
+
+        switch (index) {
+            case paramFilterMode:
+                parameter.name = "Filter Mode";
+                parameter.symbol = "filter_mode";
+                parameter.hints = kParameterIsAutomable | kParameterIsInteger;
+                parameter.enumValues.restrictedMode = true;
+                setEnumValues(parameter.enumValues, paramEnumSysFilterModes);
+                break;
+            case paramSystemExclusive:
+                parameter.name = "System Exclusive (F0)";
+                parameter.shortName = "F0: SysEx";
+                parameter.symbol = "sysex";
+                break;
+            case paramMTCQuarterFrame:
+                parameter.name = "MTC Quarter Frame (F1)";
+                parameter.shortName = "F1: MTC";
+                parameter.symbol = "mtc_quarter_frame";
+                break;
+            case paramSongPositionPointer:
+                parameter.name = "Song Position Pointer (F2)";
+                parameter.shortName = "F2: SPP";
+                parameter.symbol = "song_position_pointer";
+                break;
+            case paramSongSelect:
+                parameter.name = "Song Select (F3)";
+                parameter.shortName = "F3: SS";
+                parameter.symbol = "song_select";
+                break;
+            case paramTuneRequest:
+                parameter.name = "Tune Request (F6)";
+                parameter.shortName = "F6: Tune Req.";
+                parameter.symbol = "tune_request";
+                break;
+            case paramTimingClock:
+                parameter.name = "Timing Clock (F8)";
+                parameter.shortName = "F8: Clock";
+                parameter.symbol = "timing_clock";
+                break;
+            case paramStart:
+                parameter.name = "Start (FA)";
+                parameter.shortName = "FA: Start";
+                parameter.symbol = "start";
+                break;
+            case paramContinue:
+                parameter.name = "Continue (FB)";
+                parameter.shortName = "FB: Cont.";
+                parameter.symbol = "continue";
+                break;
+            case paramStop:
+                parameter.name = "Stop (FC)";
+                parameter.shortName = "FC: Stop";
+                parameter.symbol = "stop";
+                break;
+            case paramActiveSensing:
+                parameter.name = "Active Sensing (FE)";
+                parameter.shortName = "FE: Act. Sens.";
+                parameter.symbol = "active_sensing";
+                break;
+            case paramSystemReset:
+                parameter.name = "System Reset (FF)";
+                parameter.shortName = "FF: Reset";
+                parameter.symbol = "system_reset";
+                break;
+            case paramUndefined:
+                parameter.name = "Undefined (F4/F5/F9/FD)";
+                parameter.shortName = "F4/F5/F9/FD";
+                parameter.symbol = "undefined";
+                break;
+        }
+    }
+
+    float getParameterValue(uint32_t index) const override {
+        return fParams[index];
+    }
+
+    void setParameterValue(uint32_t index, float value) override {
+        fParams[index] = value;
+        publish();
+    }
+
+    void setParameterValues(const float* values) override {
+        std::copy(values, values + paramCount, fParams);
+        publish();
+    }
+
+    template <class Sink>
+    void run(const MidiEvent* events, uint32_t eventCount, Sink& out) {
+        const Filter& filter = fFilter.read();
+
+        if (filter.bypass) {
+            for (uint32_t i=0; i<eventCount; ++i)
+                out.write(events[i]);
+
+            return;
+        }
+
+        const bool pass_other = filter.passOther;
+
+        dispatchMidiEvents(fClassifier, events, eventCount,
+            [&](const MidiEvent* run, uint32_t count) {
+                if (pass_other) {
+                    for (uint32_t i=0; i<count; ++i)
+                        out.write(run[i]);
+                }
+            },
+            [&](const MidiEvent& event) {
+                bool pass;
+
+                if (event.size > MidiEvent::kDataSize &&
+                    event.dataExt[0] == MIDI_SYSTEM_EXCLUSIVE)
+                {
+                    pass = filter.passSysEx;
+                }
+                else {
+                    pass = filter.pass[event.data[0]];
+                }
+
+                if (pass) out.write(event);
+            });
+    }
+
+    void process(const MidiEvent* events, uint32_t eventCount, MidiEventBuffer& out) override {
+        run(events, eventCount, out);
+    }
+
+private:
+    // Pass/block decision for each status byte and bypass flag, derived
+    // from the parameters
+    struct Filter {
+        bool bypass;
+        bool passOther;
+        bool passSysEx;
+        bool pass[256];
+    };
+
+    /**
+      Build the filter table for the current parameters and pass it to run().
+      Bypass is set if the parameters let every event pass unchanged, i.e.
+      filter mode is "Block disabled events" and no event type is disabled.
+    */
+    void publish() {
+        Filter& filter = fFilter.edit();
+        bool bypass = fParams[paramFilterMode] == 0;
+
+        for (int i=1; bypass && i<paramCount; i++) {
+            bypass = (bool) fParams[i];
+        }
+
+        filter.bypass = bypass;
+        filter.passOther = fParams[paramFilterMode] == 0;
+        filter.passSysEx = (bool) fParams[paramSystemExclusive];
+        std::fill(filter.pass, filter.pass + 256, filter.passOther);
+        filter.pass[MIDI_MTC_QUARTER_FRAME] = (bool) fParams[paramMTCQuarterFrame];
+        filter.pass[MIDI_SONG_POSITION_POINTER] = (bool) fParams[paramSongPositionPointer];
+        filter.pass[MIDI_SONG_SELECT] = (bool) fParams[paramSongSelect];
+        filter.pass[MIDI_TUNE_REQUEST] = (bool) fParams[paramTuneRequest];
+        filter.pass[MIDI_TIMING_CLOCK] = (bool) fParams[paramTimingClock];
+        filter.pass[MIDI_START] = (bool) fParams[paramStart];
+        filter.pass[MIDI_CONTINUE] = (bool) fParams[paramContinue];
+        filter.pass[MIDI_STOP] = (bool) fParams[paramStop];
+        filter.pass[MIDI_ACTIVE_SENSING] = (bool) fParams[paramActiveSensing];
+        filter.pass[MIDI_SYSTEM_RESET] = (bool) fParams[paramSystemReset];
+        filter.pass[MIDI_UNDEFINED_F4] = (bool) fParams[paramUndefined];
+        filter.pass[MIDI_UNDEFINED_F5] = (bool) fParams[paramUndefined];
+        filter.pass[MIDI_UNDEFINED_F9] = (bool) fParams[paramUndefined];
+        filter.pass[MIDI_UNDEFINED_FD] = (bool) fParams[paramUndefined];
+        fFilter.publish();
+    }
+
+    float fParams[paramCount];
+    MidiEventClassifier fClassifier;
+    ConfigSnapshot<Filter> fFilter;
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_SYSFILTER_PROCESSOR_H
@@ -28,47 +28,15 @@
 #define PLUGIN_MIDISYSFILTER_H
 
 #include "DistrhoPlugin.hpp"
+#include "MIDIProcessorPlugin.hpp"
+#include "MIDISysFilterProcessor.hpp"
 
 START_NAMESPACE_DISTRHO
 
-#define MIDI_SYSTEM_EXCLUSIVE 0xF0
-#define MIDI_MTC_QUARTER_FRAME 0xF1
-#define MIDI_SONG_POSITION_POINTER 0xF2
-#define MIDI_SONG_SELECT 0xF3
-#define MIDI_UNDEFINED_F4 0xF4
-#define MIDI_UNDEFINED_F5 0xF5
-#define MIDI_TUNE_REQUEST 0xF6
-#define MIDI_END_OF_EXCLUSIVE 0xF7
-#define MIDI_TIMING_CLOCK 0xF8
-#define MIDI_UNDEFINED_F9 0xF9
-#define MIDI_START 0xFA
-#define MIDI_CONTINUE 0xFB
-#define MIDI_STOP 0xFC
-#define MIDI_UNDEFINED_FD 0xFD
-#define MIDI_ACTIVE_SENSING 0xFE
-#define MIDI_SYSTEM_RESET 0xFF
-
 // -----------------------------------------------------------------------
 
-class PluginMIDISysFilter : public Plugin {
+class PluginMIDISysFilter : public MidiProcessorPlugin<MidiSysFilterProcessor> {
 public:
-    enum Parameters {
-        paramFilterMode,
-        paramSystemExclusive,
-        paramMTCQuarterFrame,
-        paramSongPositionPointer,
-        paramSongSelect,
-        paramTuneRequest,
-        paramTimingClock,
-        paramStart,
-        paramContinue,
-        paramStop,
-        paramActiveSensing,
-        paramSystemReset,
-        paramUndefined,
-        paramCount
-    };
-
     PluginMIDISysFilter();
 
 protected:
@@ -111,14 +79,11 @@ protected:
     // -------------------------------------------------------------------
     // Init
 
-    void initParameter(uint32_t index, Parameter& parameter) override;
     void initProgramName(uint32_t index, String& programName) override;
 
     // -------------------------------------------------------------------
     // Internal data
 
-    float getParameterValue(uint32_t index) const override;
-    void setParameterValue(uint32_t index, float value) override;
     void loadProgram(uint32_t index) override;
 
     // -------------------------------------------------------------------
@@ -132,18 +97,72 @@ protected:
 
     void activate() override;
 
-    void run(const float**, float**, uint32_t,
-             const MidiEvent* midiEvents, uint32_t midiEventCount) override;
-
-
     // -------------------------------------------------------------------
 
 private:
-    float fParams[paramCount];
-
     DISTRHO_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginMIDISysFilter)
 };
 
+struct Preset {
+    const char* name;
+    const float params[PluginMIDISysFilter::paramCount];
+};
+
+// Parameter order: Filter Mode, F0, F1, F2, F3, F6, F8, FA, FB, FC, FE, FF,
+// F4/F5/F9/FD
+const Preset factoryPresets[] = {
+    {
+        "Pass-through",
+        {0.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0}
+    },
+    {
+        "Block any System message",
+        {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0}
+    },
+    {
+        "Block System Exclusive",
+        {0.0, 0.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0}
+    },
+    {
+        "Block System Common",
+        {0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0}
+    },
+    {
+        "Block System Real-Time",
+        {0.0, 1.0, 1.0, 1.0, 1.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0}
+    },
+    {
+        "Block Undefined",
+        {0.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 0.0}
+    },
+    {
+        "Block Active Sensing",
+        {0.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 0.0, 1.0, 1.0}
+    },
+    {
+        "Block Timing Clock",
+        {0.0, 1.0, 1.0, 1.0, 1.0, 1.0, 0.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0}
+    },
+    {
+        "Pass System messages only",
+        {1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0}
+    },
+    {
+        "Pass System Exclusive only",
+        {1.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0}
+    },
+    {
+        "Pass System Common only",
+        {1.0, 0.0, 1.0, 1.0, 1.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0}
+    },
+    {
+        "Pass System Real-Time only",
+        {1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 0.0}
+    }
+};
+
+const uint presetCount = sizeof(factoryPresets) / sizeof(Preset);
+
 // -----------------------------------------------------------------------
 
 END_NAMESPACE_DISTRHO
@@ -0,0 +1,67 @@
+/*
+ * Combined LV2 entry point of the midiomatic plugins
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+/*
+  The LV2 entry point of the combined bundle. Each plugin is compiled with
+  its own copy of the DPF LV2 wrapper, whose lv2_descriptor() is renamed to
+  <Plugin>_lv2_descriptor() and only returns the plugin's descriptor for
+  index 0. Here they are put together in one list.
+*/
+
+#include "lv2/lv2.h"
+
+#define MIDI_PLUGIN_DESCRIPTOR(plugin) \
+    extern "C" const LV2_Descriptor* plugin ## _lv2_descriptor(uint32_t index);
+
+// Must match the list in the Makefile
+MIDI_PLUGIN_DESCRIPTOR(MIDICCMapX4)
+MIDI_PLUGIN_DESCRIPTOR(MIDICCRecorder)
+MIDI_PLUGIN_DESCRIPTOR(MIDICCToPressure)
+MIDI_PLUGIN_DESCRIPTOR(MIDIChain)
+MIDI_PLUGIN_DESCRIPTOR(MIDIPBToCC)
+MIDI_PLUGIN_DESCRIPTOR(MIDIPressureToCC)
+MIDI_PLUGIN_DESCRIPTOR(MIDIRules)
+MIDI_PLUGIN_DESCRIPTOR(MIDISysFilter)
+
+typedef const LV2_Descriptor* (*MidiPluginDescriptorFunc)(uint32_t index);
+
+static const MidiPluginDescriptorFunc midiPluginDescriptors[] = {
+    MIDICCMapX4_lv2_descriptor,
+    MIDICCRecorder_lv2_descriptor,
+    MIDICCToPressure_lv2_descriptor,
+    MIDIChain_lv2_descriptor,
+    MIDIPBToCC_lv2_descriptor,
+    MIDIPressureToCC_lv2_descriptor,
+    MIDIRules_lv2_descriptor,
+    MIDISysFilter_lv2_descriptor
+};
+
+static const uint32_t midiPluginCount = sizeof(midiPluginDescriptors) / sizeof(MidiPluginDescriptorFunc);
+
+extern "C" LV2_SYMBOL_EXPORT
+const LV2_Descriptor* lv2_descriptor(uint32_t index) {
+    return index < midiPluginCount ? midiPluginDescriptors[index](0) : nullptr;
+}
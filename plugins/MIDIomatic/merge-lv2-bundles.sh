@@ -0,0 +1,66 @@
+#!/bin/bash
+#
+# Merge the TTL files of separate LV2 plugin bundles into one bundle, whose
+# plugins all live in one shared object.
+#
+# Usage: merge-lv2-bundles.sh BUNDLE BINARY PLUGIN_BUNDLE...
+#
+# The lv2:binary of every plugin is set to BINARY. TTL files, whose name
+# doesn't start with the plugin bundle's name (e.g. presets.ttl), are
+# renamed, so they don't overwrite each other.
+
+set -e
+
+bundle="$1"
+binary="$2"
+shift 2
+
+if [[ -z "$bundle" || -z "$binary" || $# -eq 0 ]]; then
+    echo "Usage: $0 BUNDLE BINARY PLUGIN_BUNDLE..." >&2
+    exit 2
+fi
+
+mkdir -p "$bundle"
+rm -f "$bundle"/*.ttl
+prefixes="$(mktemp)"
+body="$(mktemp)"
+trap 'rm -f "$prefixes" "$body"' EXIT
+
+for plugin in "$@"; do
+    name="$(basename "$plugin" .lv2)"
+
+    if [[ ! -f "$plugin/manifest.ttl" ]]; then
+        echo "$plugin/manifest.ttl not found, build and generate the plugins first." >&2
+        exit 1
+    fi
+
+    renames=()
+
+    for ttl in "$plugin"/*.ttl; do
+        file="$(basename "$ttl")"
+
+        if [[ "$file" != manifest.ttl && "$file" != "$name"* ]]; then
+            renames+=(-e "s|<$file>|<$name-$file>|g")
+        fi
+    done
+
+    for ttl in "$plugin"/*.ttl; do
+        file="$(basename "$ttl")"
+        sed_args=(-e "s|lv2:binary <[^>]*>|lv2:binary <$binary>|g" "${renames[@]}")
+
+        if [[ "$file" == manifest.ttl ]]; then
+            # all prefixes go to the top of the merged manifest, once
+            grep '^@prefix' "$ttl" >> "$prefixes" || true
+            sed "${sed_args[@]}" -e '/^@prefix/d' "$ttl" >> "$body"
+        elif [[ "$file" == "$name"* ]]; then
+            sed "${sed_args[@]}" "$ttl" > "$bundle/$file"
+        else
+            sed "${sed_args[@]}" "$ttl" > "$bundle/$name-$file"
+        fi
+    done
+done
+
+awk '!seen[$0]++' "$prefixes" > "$bundle/manifest.ttl"
+cat "$body" >> "$bundle/manifest.ttl"
+
+echo "Created LV2 bundle $bundle with $# plugins"
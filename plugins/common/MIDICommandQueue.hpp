@@ -0,0 +1,118 @@
+/*
+ * Wait-free command queue for midiomatic plugins
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_COMMAND_QUEUE_H
+#define MIDI_COMMAND_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIUtils.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Single-producer, single-consumer queue of commands for run().
+
+  Actions requested through parameters, e.g. triggers, are pushed by the
+  thread calling setParameterValue() and popped at the start of run(), so
+  they are only ever carried out in the audio thread and at a defined point
+  in the block. Both ends are wait-free. When the queue is full, new
+  commands are dropped and counted.
+*/
+class MidiCommandQueue {
+public:
+    static constexpr uint32_t kCapacity = 32;
+
+    struct Command {
+        uint32_t id;
+        // frame in the next block the command applies to
+        uint32_t frame;
+    };
+
+    MidiCommandQueue() noexcept
+        : fHead(0),
+          fTail(0),
+          fDroppedCount(0) {
+        static_assert(offsetof(MidiCommandQueue, fTail) - offsetof(MidiCommandQueue, fHead) >= CACHE_LINE_SIZE,
+                      "producer and consumer index share a cache line");
+    }
+
+    /**
+      Queue command @a id. Only called by the producer.
+      Returns false if the queue is full.
+    */
+    bool push(uint32_t id, uint32_t frame = 0) noexcept {
+        const uint32_t tail = fTail.load(std::memory_order_relaxed);
+
+        if (tail - fHead.load(std::memory_order_acquire) >= kCapacity) {
+            ++fDroppedCount;
+            return false;
+        }
+
+        Command& cmd(fCommands[tail % kCapacity]);
+        cmd.id = id;
+        cmd.frame = frame;
+        fTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+      Take the oldest command from the queue. Only called by the consumer.
+      Returns false if the queue is empty.
+    */
+    bool pop(Command& cmd) noexcept {
+        const uint32_t head = fHead.load(std::memory_order_relaxed);
+
+        if (head == fTail.load(std::memory_order_acquire))
+            return false;
+
+        cmd = fCommands[head % kCapacity];
+        fHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t getDroppedCount() const noexcept {
+        return fDroppedCount;
+    }
+
+private:
+    Command fCommands[kCapacity];
+    std::atomic<uint32_t> fHead;
+    // consumer and producer index on separate cache lines
+    char fPadding[CACHE_LINE_SIZE];
+    std::atomic<uint32_t> fTail;
+    uint32_t fDroppedCount;
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_COMMAND_QUEUE_H
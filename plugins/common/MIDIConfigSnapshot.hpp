@@ -0,0 +1,102 @@
+/*
+ * Lock-free configuration snapshots for midiomatic MIDI processors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_CONFIG_SNAPSHOT_H
+#define MIDI_CONFIG_SNAPSHOT_H
+
+#include <atomic>
+
+#include "DistrhoPlugin.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Passes a configuration derived from several parameters from the thread,
+  which sets the parameters, to the audio thread as one consistent unit.
+
+  The writer builds the next configuration in edit() and makes it current
+  with publish(), which swaps the slot index with the shared one. The reader
+  calls read() once at the start of a block and uses the returned
+  configuration until the end of the block. It picks up the last published
+  one, if there is a new one, by swapping its own slot index with the shared
+  one.
+
+  Besides the slot being read and the one being written, a third slot is
+  kept in between, so the writer can publish any number of times while the
+  reader is using its slot and neither side ever waits for the other or sees
+  a configuration in the middle of an update. There must only be one writer
+  and one reader thread at a time. A slot returned by edit() may hold an
+  older configuration, so the writer always has to fill in all of it.
+*/
+template <class T>
+class ConfigSnapshot {
+public:
+    ConfigSnapshot() noexcept
+        : fWrite(0),
+          fRead(1),
+          fShared(2) {}
+
+    /**
+      Return the slot for the writer to build the next configuration in.
+    */
+    T& edit() noexcept {
+        return fSlots[fWrite];
+    }
+
+    /**
+      Make the configuration built in edit() the one read() returns next.
+    */
+    void publish() noexcept {
+        fWrite = fShared.exchange(fWrite | kFresh, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    /**
+      Return the last published configuration. Only called by the reader.
+    */
+    const T& read() noexcept {
+        if (fShared.load(std::memory_order_relaxed) & kFresh)
+            fRead = fShared.exchange(fRead, std::memory_order_acq_rel) & kIndexMask;
+
+        return fSlots[fRead];
+    }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x03;
+    static constexpr uint8_t kFresh = 0x04;
+
+    T fSlots[3];
+    uint8_t fWrite;
+    uint8_t fRead;
+    std::atomic<uint8_t> fShared;
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_CONFIG_SNAPSHOT_H
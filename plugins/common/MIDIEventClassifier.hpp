@@ -0,0 +1,214 @@
+/*
+ * Block pre-classification of MIDI event buffers for midiomatic plugins
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_EVENT_CLASSIFIER_H
+#define MIDI_EVENT_CLASSIFIER_H
+
+#include "DistrhoPlugin.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIDI_CLASSIFY_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Classifies blocks of incoming MIDI events by status byte.
+
+  The status bytes of up to kChunkSize events are gathered into a compact
+  buffer and compared against up to kMaxMatches (type, channel) pairs at once,
+  using AVX2 or SSE2 where available and a scalar loop otherwise. The result
+  is a bitmask with one bit per event, which lets the plugin jump straight to
+  the events it is interested in and forward the runs in between unchanged.
+*/
+class MidiEventClassifier {
+public:
+    static constexpr uint32_t kChunkSize = 64;
+    static constexpr uint32_t kMaxMatches = 2;
+
+    MidiEventClassifier() noexcept
+        : fNumMatches(0) {}
+
+    /**
+      Remove all match rules.
+    */
+    void clear() noexcept {
+        fNumMatches = 0;
+    }
+
+    /**
+      Add a match rule for status @a type (upper nibble, e.g. 0xB0) on MIDI
+      @a channel (0-15, or -1 for any channel).
+      For System messages (type 0xF0) the channel is ignored.
+      Returns false if the maximum number of rules is already set.
+    */
+    bool addMatch(uint8_t type, int8_t channel = -1) noexcept {
+        if (fNumMatches >= kMaxMatches)
+            return false;
+
+        if (type == 0xF0 || channel < 0) {
+            fMasks[fNumMatches] = 0xF0;
+            fValues[fNumMatches] = type & 0xF0;
+        }
+        else {
+            fMasks[fNumMatches] = 0xFF;
+            fValues[fNumMatches] = (type & 0xF0) | (channel & 0x0F);
+        }
+
+        fNumMatches++;
+        return true;
+    }
+
+    /**
+      Classify @a count (at most kChunkSize) events starting at @a events.
+      Returns a bitmask with bit n set if events[n] matches any rule.
+    */
+    uint64_t classify(const MidiEvent* events, uint32_t count) const noexcept {
+        alignas(32) uint8_t status[kChunkSize];
+        uint32_t i = 0;
+
+        for (; i < count; ++i)
+            status[i] = events[i].size > MidiEvent::kDataSize ? events[i].dataExt[0] : events[i].data[0];
+
+        // Padding never matches, since rule values always have the high bit set
+        for (; i < kChunkSize; ++i)
+            status[i] = 0;
+
+        uint64_t result = 0;
+
+        for (uint32_t m = 0; m < fNumMatches; ++m)
+            result |= matchStatus(status, fMasks[m], fValues[m]);
+
+        return result;
+    }
+
+    /**
+      Return the index of the lowest set bit in the (non-zero) @a mask.
+    */
+    static inline uint32_t firstMatch(uint64_t mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return (uint32_t) __builtin_ctzll(mask);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        unsigned long idx;
+        _BitScanForward64(&idx, mask);
+        return (uint32_t) idx;
+#else
+        uint32_t idx = 0;
+
+        while (!(mask & 1)) {
+            mask >>= 1;
+            ++idx;
+        }
+
+        return idx;
+#endif
+    }
+
+private:
+    static inline uint64_t matchStatus(const uint8_t* status, uint8_t mask, uint8_t value) noexcept {
+        uint64_t result = 0;
+#if defined(__AVX2__)
+        const __m256i vmask = _mm256_set1_epi8((char) mask);
+        const __m256i vvalue = _mm256_set1_epi8((char) value);
+
+        for (uint32_t i = 0; i < kChunkSize; i += 32) {
+            const __m256i v = _mm256_load_si256((const __m256i*)(status + i));
+            const __m256i eq = _mm256_cmpeq_epi8(_mm256_and_si256(v, vmask), vvalue);
+            result |= (uint64_t)(uint32_t) _mm256_movemask_epi8(eq) << i;
+        }
+#elif defined(MIDI_CLASSIFY_SSE2)
+        const __m128i vmask = _mm_set1_epi8((char) mask);
+        const __m128i vvalue = _mm_set1_epi8((char) value);
+
+        for (uint32_t i = 0; i < kChunkSize; i += 16) {
+            const __m128i v = _mm_load_si128((const __m128i*)(status + i));
+            const __m128i eq = _mm_cmpeq_epi8(_mm_and_si128(v, vmask), vvalue);
+            result |= (uint64_t)(uint32_t) _mm_movemask_epi8(eq) << i;
+        }
+#else
+        for (uint32_t i = 0; i < kChunkSize; ++i) {
+            if ((status[i] & mask) == value)
+                result |= (uint64_t) 1 << i;
+        }
+#endif
+        return result;
+    }
+
+    uint8_t fMasks[kMaxMatches];
+    uint8_t fValues[kMaxMatches];
+    uint32_t fNumMatches;
+};
+
+// -----------------------------------------------------------------------
+
+/**
+  Walk the events in @a events in chunks classified by @a classifier.
+
+  For every run of non-matching events @a forward(first, count) is called
+  once and for every matching event @a handle(event). Calls are made in
+  event order.
+*/
+template <class Forward, class Handle>
+static inline void dispatchMidiEvents(const MidiEventClassifier& classifier,
+                                      const MidiEvent* events, uint32_t eventCount,
+                                      Forward forward, Handle handle) {
+    for (uint32_t base = 0; base < eventCount; base += MidiEventClassifier::kChunkSize) {
+        const MidiEvent* chunk = events + base;
+        const uint32_t count = eventCount - base < MidiEventClassifier::kChunkSize
+                             ? eventCount - base : MidiEventClassifier::kChunkSize;
+        uint64_t matches = classifier.classify(chunk, count);
+        uint32_t next = 0;
+
+        while (matches) {
+            const uint32_t idx = MidiEventClassifier::firstMatch(matches);
+            matches &= matches - 1;
+
+            if (idx > next)
+                forward(chunk + next, idx - next);
+
+            handle(chunk[idx]);
+            next = idx + 1;
+        }
+
+        if (count > next)
+            forward(chunk + next, count - next);
+    }
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_EVENT_CLASSIFIER_H
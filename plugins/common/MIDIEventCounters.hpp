@@ -0,0 +1,179 @@
+/*
+ * Realtime event counters for midiomatic plugins
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_EVENT_COUNTERS_H
+#define MIDI_EVENT_COUNTERS_H
+
+#include <cstdint>
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIProbes.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Per-instance event counters, which the plugins show as output parameters.
+
+  run() updates plain integer counters and calls publish() once at the end
+  of the block, which copies them to the values the host reads with
+  getParameterValue(). The counts start when the plugin is created. Output
+  parameters are floats, so counts above 2^24 lose precision.
+*/
+class MidiEventCounters {
+public:
+    enum Counters {
+        kEventsIn,
+        kEventsOut,
+        kEventsGenerated,
+        kEventsDropped,
+        kMaxBlockEvents,
+        kEventsDeferred,
+        kCount
+    };
+
+    MidiEventCounters() noexcept
+        : fInputBegin(0),
+          fInputEnd(0)
+    {
+        for (uint32_t i=0; i < kCount; i++) {
+            fCounts[i] = 0;
+            fValues[i] = 0.0f;
+        }
+    }
+
+    /**
+      Set up the output parameter for @a counter.
+    */
+    static void initParameter(uint32_t counter, Parameter& parameter) {
+        parameter.hints = kParameterIsOutput | kParameterIsInteger;
+        parameter.ranges.def = 0;
+        parameter.ranges.min = 0;
+        parameter.ranges.max = 16777216;
+
+        switch (counter) {
+            case kEventsIn:
+                parameter.name = "Events in";
+                parameter.symbol = "events_in";
+                break;
+            case kEventsOut:
+                parameter.name = "Events out";
+                parameter.symbol = "events_out";
+                break;
+            case kEventsGenerated:
+                parameter.name = "Events generated";
+                parameter.symbol = "events_generated";
+                break;
+            case kEventsDropped:
+                parameter.name = "Events dropped";
+                parameter.symbol = "events_dropped";
+                break;
+            case kMaxBlockEvents:
+                parameter.name = "Max. events per block";
+                parameter.shortName = "Max. events";
+                parameter.symbol = "events_max";
+                parameter.ranges.max = 65536;
+                break;
+            case kEventsDeferred:
+                parameter.name = "Events deferred";
+                parameter.symbol = "events_deferred";
+                break;
+        }
+    }
+
+    float getValue(uint32_t counter) const noexcept {
+        return counter < kCount ? fValues[counter] : 0.0f;
+    }
+
+    /**
+      Count the @a eventCount input events of a block. Output events, which
+      are not one of these, are counted as generated.
+    */
+    inline void beginBlock(const MidiEvent* events, uint32_t eventCount) noexcept {
+        setInput(events, eventCount);
+        fCounts[kEventsIn] += eventCount;
+
+        if (eventCount > fCounts[kMaxBlockEvents])
+            fCounts[kMaxBlockEvents] = eventCount;
+    }
+
+    /**
+      Set the events the next output events are compared with, e.g. the
+      input of the next stage in a chain.
+    */
+    inline void setInput(const MidiEvent* events, uint32_t eventCount) noexcept {
+        fInputBegin = (uintptr_t) events;
+        fInputEnd = (uintptr_t) (events + eventCount);
+    }
+
+    /**
+      Count an event written to the output.
+    */
+    inline void countOutput(const MidiEvent& event) noexcept {
+        ++fCounts[kEventsOut];
+        countGenerated(event);
+    }
+
+    /**
+      Count @a event as generated if it is not one of the input events.
+      Processors pass input events on by reference, so anything else was
+      generated.
+    */
+    inline void countGenerated(const MidiEvent& event) noexcept {
+        const uintptr_t addr = (uintptr_t) &event;
+
+        if (addr < fInputBegin || addr >= fInputEnd) {
+            MIDI_PROBE3(event_generated, event.frame, MIDI_PROBE_STATUS(event), event.data[1]);
+            ++fCounts[kEventsGenerated];
+        }
+    }
+
+    /**
+      Make the counts visible to the host. @a droppedCount is the total number
+      of events lost so far, e.g. by the overflow ring, and @a deferredCount
+      the number of events carried over into a later block.
+    */
+    inline void publish(uint32_t droppedCount, uint32_t deferredCount) noexcept {
+        fCounts[kEventsDropped] = droppedCount;
+        fCounts[kEventsDeferred] = deferredCount;
+
+        for (uint32_t i=0; i < kCount; i++)
+            fValues[i] = (float) fCounts[i];
+    }
+
+private:
+    uintptr_t fInputBegin;
+    uintptr_t fInputEnd;
+    uint64_t fCounts[kCount];
+    float fValues[kCount];
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_EVENT_COUNTERS_H
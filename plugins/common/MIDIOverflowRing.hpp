@@ -0,0 +1,153 @@
+/*
+ * Carry-over queue for MIDI output events of midiomatic plugins
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_OVERFLOW_RING_H
+#define MIDI_OVERFLOW_RING_H
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIProbes.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Fixed-capacity ring for output events, which the host did not accept.
+
+  writeMidiEvent() returns false when the host's output buffer is full.
+  Instead of dropping the event, write() puts it into this ring, and every
+  event after it in the same block as well, so output order is kept. At the
+  start of the next run() flush() writes the queued events again with frame
+  0, i.e. they arrive one block late instead of not at all.
+
+  Events with external data (size > MidiEvent::kDataSize) point into the
+  host's input buffer, which is only valid during the current run(), so they
+  cannot be carried over and are dropped.
+*/
+class MidiOverflowRing {
+public:
+    static constexpr uint32_t kCapacity = 256;
+
+    MidiOverflowRing() noexcept
+        : fHead(0),
+          fCount(0),
+          fDeferredCount(0),
+          fDroppedCount(0) {}
+
+    bool isEmpty() const noexcept {
+        return fCount == 0;
+    }
+
+    /**
+      Discard all queued events. The counters are kept.
+    */
+    void clear() noexcept {
+        fHead = 0;
+        fCount = 0;
+    }
+
+    /**
+      Number of events, which could not be written in the block they were
+      generated in and were queued for the next one.
+    */
+    uint32_t getDeferredCount() const noexcept {
+        return fDeferredCount;
+    }
+
+    /**
+      Number of events, which were lost, because the ring was full or they
+      had external data.
+    */
+    uint32_t getDroppedCount() const noexcept {
+        return fDroppedCount;
+    }
+
+    /**
+      Write @a event with @a writeFunc(event), or queue it if there are still
+      queued events or the write fails.
+      Returns true if the event was written to the host immediately.
+    */
+    template <class Write>
+    inline bool write(const MidiEvent& event, Write writeFunc) {
+        if (fCount == 0) {
+            if (writeFunc(event))
+                return true;
+
+            MIDI_PROBE2(write_failed, event.frame, MIDI_PROBE_STATUS(event));
+        }
+
+        push(event);
+        return false;
+    }
+
+    /**
+      Write queued events with @a writeFunc(event) at frame 0, until the ring
+      is empty or a write fails. Call this at the start of run().
+      Returns true if the ring is empty afterwards.
+    */
+    template <class Write>
+    bool flush(Write writeFunc) {
+        while (fCount > 0) {
+            MidiEvent& event(fEvents[fHead]);
+            event.frame = 0;
+
+            if (!writeFunc(event)) {
+                MIDI_PROBE2(write_failed, event.frame, MIDI_PROBE_STATUS(event));
+                return false;
+            }
+
+            fHead = (fHead + 1) & (kCapacity - 1);
+            --fCount;
+        }
+
+        return true;
+    }
+
+private:
+    void push(const MidiEvent& event) noexcept {
+        if (fCount >= kCapacity || event.size > MidiEvent::kDataSize) {
+            MIDI_PROBE2(event_dropped, event.frame, MIDI_PROBE_STATUS(event));
+            ++fDroppedCount;
+            return;
+        }
+
+        fEvents[(fHead + fCount) & (kCapacity - 1)] = event;
+        ++fCount;
+        ++fDeferredCount;
+    }
+
+    MidiEvent fEvents[kCapacity];
+    uint32_t fHead;
+    uint32_t fCount;
+    uint32_t fDeferredCount;
+    uint32_t fDroppedCount;
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_OVERFLOW_RING_H
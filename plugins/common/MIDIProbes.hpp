@@ -0,0 +1,71 @@
+/*
+ * Optional USDT probes for midiomatic plugins
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_PROBES_H
+#define MIDI_PROBES_H
+
+/*
+  Static tracepoints (USDT) in the processing paths of the plugins, for use
+  with perf, bpftrace, SystemTap etc. on a running host. They are compiled in
+  with "make USDT=true", which needs <sys/sdt.h> (e.g. from systemtap-sdt-dev),
+  and are empty otherwise.
+
+  All probes use the provider "midiomatic":
+
+    run_entry(event_count)                  start of run()
+    run_exit(event_count)                   end of run()
+    event_generated(frame, status, data1)   per event created by a processor
+    write_failed(frame, status)             writeMidiEvent() returned false
+    event_dropped(frame, status)            output event lost
+    state_load(key)                         setState()
+    state_save(key)                         getState()
+
+  Example:
+
+    bpftrace -e 'usdt:/usr/local/lib/lv2/midipbtocc.lv2/midipbtocc_dsp.so:midiomatic:run_entry { @[pid] = count(); }'
+*/
+
+#ifndef MIDI_USDT
+#define MIDI_USDT 0
+#endif
+
+#if MIDI_USDT
+#include <sys/sdt.h>
+
+#define MIDI_PROBE1(name, a)        DTRACE_PROBE1(midiomatic, name, a)
+#define MIDI_PROBE2(name, a, b)     DTRACE_PROBE2(midiomatic, name, a, b)
+#define MIDI_PROBE3(name, a, b, c)  DTRACE_PROBE3(midiomatic, name, a, b, c)
+#else
+#define MIDI_PROBE1(name, a)        do {} while (0)
+#define MIDI_PROBE2(name, a, b)     do {} while (0)
+#define MIDI_PROBE3(name, a, b, c)  do {} while (0)
+#endif
+
+// Status byte of any event, including those with external data
+#define MIDI_PROBE_STATUS(event) \
+    ((event).size > MidiEvent::kDataSize ? (event).dataExt[0] : (event).data[0])
+
+#endif  // #ifndef MIDI_PROBES_H
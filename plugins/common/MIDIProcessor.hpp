@@ -0,0 +1,176 @@
+/*
+ * Host-independent MIDI processor interface for midiomatic plugins
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_PROCESSOR_H
+#define MIDI_PROCESSOR_H
+
+#include <algorithm>
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIProbes.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+const ParameterEnumerationValue paramEnumFilterChannels[] = {
+    {0, "Any"},
+    {1, "Channel 1"},
+    {2, "Channel 2"},
+    {3, "Channel 3"},
+    {4, "Channel 4"},
+    {5, "Channel 5"},
+    {6, "Channel 6"},
+    {7, "Channel 7"},
+    {8, "Channel 8"},
+    {9, "Channel 9"},
+    {10, "Channel 10"},
+    {11, "Channel 11"},
+    {12, "Channel 12"},
+    {13, "Channel 13"},
+    {14, "Channel 14"},
+    {15, "Channel 15"},
+    {16, "Channel 16"}
+};
+
+// -----------------------------------------------------------------------
+
+/**
+  Preallocated, fixed-capacity buffer of MIDI events.
+
+  Processors write their output into it, e.g. between the stages of a chain.
+  Events which do not fit are dropped and counted. Events with external data
+  still point into the original input buffer.
+*/
+class MidiEventBuffer {
+public:
+    static constexpr uint32_t kCapacity = 1024;
+
+    MidiEventBuffer() noexcept
+        : fCount(0),
+          fDroppedCount(0) {}
+
+    void clear() noexcept {
+        fCount = 0;
+    }
+
+    inline bool write(const MidiEvent& event) noexcept {
+        if (fCount >= kCapacity) {
+            MIDI_PROBE2(event_dropped, event.frame, MIDI_PROBE_STATUS(event));
+            ++fDroppedCount;
+            return false;
+        }
+
+        fEvents[fCount++] = event;
+        return true;
+    }
+
+    const MidiEvent* data() const noexcept {
+        return fEvents;
+    }
+
+    uint32_t size() const noexcept {
+        return fCount;
+    }
+
+    uint32_t getDroppedCount() const noexcept {
+        return fDroppedCount;
+    }
+
+private:
+    MidiEvent fEvents[kCapacity];
+    uint32_t fCount;
+    uint32_t fDroppedCount;
+};
+
+// -----------------------------------------------------------------------
+
+/**
+  Interface of the MIDI processing cores of the plugins.
+
+  A processor holds the parameters and the processing state of one plugin,
+  but nothing specific to a plugin host, so it can be run by the plugin
+  itself, as a stage of the MIDI Chain plugin or by other programs.
+
+  Besides process() every processor also provides a template method
+
+      template <class Sink> void run(const MidiEvent* events, uint32_t eventCount, Sink& out);
+
+  which writes its output with out.write(event) and lets the caller avoid the
+  intermediate buffer, e.g. when writing directly to the plugin host.
+*/
+class MidiProcessor {
+public:
+    virtual ~MidiProcessor() {}
+
+    virtual uint32_t getParameterCount() const = 0;
+    virtual void initParameter(uint32_t index, Parameter& parameter) const = 0;
+    virtual float getParameterValue(uint32_t index) const = 0;
+    virtual void setParameterValue(uint32_t index, float value) = 0;
+
+    /**
+      Set all parameters from @a values, e.g. when loading a preset.
+      Processors, which derive their settings from several parameters, apply
+      the new values in one step, so they never process a block with only
+      some of them changed.
+    */
+    virtual void setParameterValues(const float* values) {
+        for (uint32_t i=0; i < getParameterCount(); i++)
+            setParameterValue(i, values[i]);
+    }
+
+    /**
+      Process @a eventCount events, sorted by frame, and append the output
+      to @a out.
+    */
+    virtual void process(const MidiEvent* events, uint32_t eventCount, MidiEventBuffer& out) = 0;
+
+    /**
+      Forget the processing state, e.g. the last values of a duplicate
+      filter, but keep the parameters, so the next event is processed like
+      the first one. Called between independent streams of events.
+    */
+    virtual void reset() {}
+
+protected:
+    /**
+      Set all parameters to the default values given by initParameter().
+      Called by the constructors of the derived processors.
+    */
+    void loadDefaults() {
+        for (uint32_t i=0; i < getParameterCount(); i++) {
+            Parameter parameter;
+            initParameter(i, parameter);
+            setParameterValue(i, parameter.ranges.def);
+        }
+    }
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_PROCESSOR_H
@@ -0,0 +1,151 @@
+/*
+ * Plugin wrapper for midiomatic MIDI processors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_PROCESSOR_PLUGIN_H
+#define MIDI_PROCESSOR_PLUGIN_H
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIEventCounters.hpp"
+#include "MIDIOverflowRing.hpp"
+#include "MIDIProbes.hpp"
+#include "MIDIRealtimeCheck.hpp"
+#include "MIDIProcessor.hpp"
+#include "MIDIRunTimer.hpp"
+#include "MIDIUtils.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Base class for plugins, which wrap a single MIDI processor.
+
+  It forwards the parameters to the processor and runs it with the host as
+  the output, so generated events are written to the host directly. Events
+  the host does not accept are carried over into the next block. The event
+  counters follow the processor's parameters as output parameters.
+
+  The plugin itself adds the plugin information, programs and presets.
+*/
+template <class Processor>
+class MidiProcessorPlugin : public Plugin {
+public:
+    enum {
+        paramCount = Processor::paramCount
+    };
+
+    MidiProcessorPlugin(uint32_t programCount, uint32_t stateCount)
+        : Plugin(paramCount + MidiEventCounters::kCount, programCount, stateCount) {}
+
+protected:
+    // -------------------------------------------------------------------
+    // Init
+
+    void initParameter(uint32_t index, Parameter& parameter) override {
+        if (index < paramCount)
+            fProcessor.initParameter(index, parameter);
+        else
+            MidiEventCounters::initParameter(index - paramCount, parameter);
+    }
+
+    // -------------------------------------------------------------------
+    // Internal data
+
+    float getParameterValue(uint32_t index) const override {
+        if (index < paramCount)
+            return fProcessor.getParameterValue(index);
+
+        return fCounters.getValue(index - paramCount);
+    }
+
+    void setParameterValue(uint32_t index, float value) override {
+        if (index < paramCount)
+            fProcessor.setParameterValue(index, value);
+    }
+
+    // -------------------------------------------------------------------
+    // Process
+
+    void run(const float**, float**, uint32_t,
+             const MidiEvent* events, uint32_t eventCount) override {
+        RealtimeScope realtime;
+        RunTimerScope timing(fRunTimer);
+        HostOutput out(this);
+
+        MIDI_PROBE1(run_entry, eventCount);
+
+        fCounters.beginBlock(events, eventCount);
+
+        // write events the host did not accept in the last block first
+        if (!fOverflow.isEmpty())
+            fOverflow.flush([this](const MidiEvent& ev) { return writeMidiEvent(ev); });
+
+        fProcessor.run(events, eventCount, out);
+        fCounters.publish(fOverflow.getDroppedCount(), fOverflow.getDeferredCount());
+        MIDI_PROBE1(run_exit, eventCount);
+    }
+
+    /**
+      Return the ring holding output events the host did not accept.
+      Its counters tell how often this happened.
+    */
+    const MidiOverflowRing& getOverflowRing() const noexcept {
+        return fOverflow;
+    }
+
+    Processor fProcessor;
+
+    // -------------------------------------------------------------------
+
+private:
+    struct HostOutput {
+        MidiProcessorPlugin* const plugin;
+
+        explicit HostOutput(MidiProcessorPlugin* p) noexcept
+            : plugin(p) {}
+
+        inline bool write(const MidiEvent& event) {
+            plugin->fCounters.countOutput(event);
+            return plugin->fOverflow.write(event, [this](const MidiEvent& ev) {
+                return plugin->writeMidiEvent(ev);
+            });
+        }
+    };
+
+    MidiOverflowRing fOverflow;
+    MidiEventCounters fCounters;
+    RunTimer fRunTimer;
+
+    // keep the data written in run() off the cache line of the next
+    // allocation, which may be another instance processed by another thread
+    char fPadding[CACHE_LINE_SIZE];
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_PROCESSOR_PLUGIN_H
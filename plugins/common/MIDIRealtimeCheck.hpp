@@ -0,0 +1,349 @@
+/*
+ * Optional realtime-safety checks for midiomatic plugins
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_REALTIME_CHECK_H
+#define MIDI_REALTIME_CHECK_H
+
+/*
+  Debug mode for catching calls in run() that are not realtime-safe. Build
+  with "make RT_CHECK=true" and load the plugins in a host as usual.
+
+  While a RealtimeScope is alive on a thread, calls from the plugin's own code
+  to malloc(), calloc(), realloc(), free(), operator new / delete,
+  pthread_mutex_lock() and the blocking calls read(), write(), open(),
+  close(), fopen(), nanosleep(), usleep(), sleep(), poll(), select() and
+  sem_wait() are reported on stderr with a backtrace. Only the first
+  kMaxReports violations are printed, later ones are just counted. The count
+  is exported as midiomatic_rt_check_violations(), so a test host like
+  tools/midiomatic-rtcheck.cpp can fail when there were any.
+
+  The plugin is linked with -Bsymbolic-functions in this mode, so the
+  replacement functions below only catch calls from within the plugin and do
+  not change the allocator of the host. This header must only be included by
+  one translation unit of a plugin, i.e. the plugin's main source file. The
+  malloc family and the checks of the other calls require glibc. Calls, which
+  _FORTIFY_SOURCE redirects to checked variants, e.g. __read_chk(), are not
+  caught.
+*/
+
+#include "DistrhoPlugin.hpp"
+
+#ifndef MIDI_RT_CHECK
+#define MIDI_RT_CHECK 0
+#endif
+
+#if MIDI_RT_CHECK
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/select.h>
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+#if MIDI_RT_CHECK
+
+namespace RealtimeCheck {
+
+static constexpr uint32_t kMaxReports = 32;
+static constexpr int kMaxFrames = 32;
+
+static thread_local uint32_t sDepth = 0;
+static std::atomic<uint32_t> sViolations(0);
+
+/**
+  Report a call to @a what if the current thread is inside a RealtimeScope.
+*/
+static void violation(const char* what) {
+    if (sDepth == 0)
+        return;
+
+    uint32_t count = sViolations.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    if (count > kMaxReports)
+        return;
+
+    // don't report the calls made while reporting
+    const uint32_t depth = sDepth;
+    sDepth = 0;
+
+    void* frames[kMaxFrames];
+    int numFrames = backtrace(frames, kMaxFrames);
+
+    std::fprintf(stderr, "midiomatic: realtime violation #%u in run(): %s\n", count, what);
+    backtrace_symbols_fd(frames, numFrames, STDERR_FILENO);
+
+    if (count == kMaxReports)
+        std::fprintf(stderr, "midiomatic: further realtime violations are not reported\n");
+
+    sDepth = depth;
+}
+
+}  // namespace RealtimeCheck
+
+/**
+  Marks the enclosing scope, e.g. the body of run(), as realtime code.
+*/
+class RealtimeScope {
+public:
+    RealtimeScope() noexcept {
+        ++RealtimeCheck::sDepth;
+    }
+
+    ~RealtimeScope() noexcept {
+        --RealtimeCheck::sDepth;
+    }
+};
+
+#else
+
+class RealtimeScope {
+public:
+    RealtimeScope() noexcept {}
+};
+
+#endif
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#if MIDI_RT_CHECK
+
+#ifdef __GLIBC__
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+static decltype(&::pthread_mutex_lock) midiRealMutexLock = nullptr;
+static decltype(&::read) midiRealRead = nullptr;
+static decltype(&::write) midiRealWrite = nullptr;
+static decltype(&::open) midiRealOpen = nullptr;
+static decltype(&::close) midiRealClose = nullptr;
+static decltype(&::fopen) midiRealFopen = nullptr;
+static decltype(&::nanosleep) midiRealNanosleep = nullptr;
+static decltype(&::usleep) midiRealUsleep = nullptr;
+static decltype(&::sleep) midiRealSleep = nullptr;
+static decltype(&::poll) midiRealPoll = nullptr;
+static decltype(&::select) midiRealSelect = nullptr;
+static decltype(&::sem_wait) midiRealSemWait = nullptr;
+
+/*
+  Look up the real functions and let backtrace() load its helper library
+  when the plugin is loaded, not in the first reported run().
+*/
+__attribute__((constructor)) static void midiRealtimeCheckInit() {
+    void* frames[1];
+    midiRealMutexLock = (decltype(midiRealMutexLock)) dlsym(RTLD_NEXT, "pthread_mutex_lock");
+    midiRealRead = (decltype(midiRealRead)) dlsym(RTLD_NEXT, "read");
+    midiRealWrite = (decltype(midiRealWrite)) dlsym(RTLD_NEXT, "write");
+    midiRealOpen = (decltype(midiRealOpen)) dlsym(RTLD_NEXT, "open");
+    midiRealClose = (decltype(midiRealClose)) dlsym(RTLD_NEXT, "close");
+    midiRealFopen = (decltype(midiRealFopen)) dlsym(RTLD_NEXT, "fopen");
+    midiRealNanosleep = (decltype(midiRealNanosleep)) dlsym(RTLD_NEXT, "nanosleep");
+    midiRealUsleep = (decltype(midiRealUsleep)) dlsym(RTLD_NEXT, "usleep");
+    midiRealSleep = (decltype(midiRealSleep)) dlsym(RTLD_NEXT, "sleep");
+    midiRealPoll = (decltype(midiRealPoll)) dlsym(RTLD_NEXT, "poll");
+    midiRealSelect = (decltype(midiRealSelect)) dlsym(RTLD_NEXT, "select");
+    midiRealSemWait = (decltype(midiRealSemWait)) dlsym(RTLD_NEXT, "sem_wait");
+    backtrace(frames, 1);
+}
+
+/**
+  Number of realtime violations reported or counted so far.
+*/
+__attribute__((visibility("default"))) uint32_t midiomatic_rt_check_violations() {
+    return DISTRHO_NAMESPACE::RealtimeCheck::sViolations.load();
+}
+
+void* malloc(size_t size) noexcept {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("malloc()");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("calloc()");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) noexcept {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("realloc()");
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) noexcept {
+    if (ptr != nullptr)
+        DISTRHO_NAMESPACE::RealtimeCheck::violation("free()");
+
+    __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("pthread_mutex_lock()");
+    return midiRealMutexLock(mutex);
+}
+
+ssize_t read(int fd, void* buf, size_t count) {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("read()");
+    return midiRealRead(fd, buf, count);
+}
+
+ssize_t write(int fd, const void* buf, size_t count) {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("write()");
+    return midiRealWrite(fd, buf, count);
+}
+
+int open(const char* path, int flags, ...) {
+    mode_t mode = 0;
+
+    if (flags & O_CREAT) {
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, mode_t);
+        va_end(args);
+    }
+
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("open()");
+    return midiRealOpen(path, flags, mode);
+}
+
+int close(int fd) {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("close()");
+    return midiRealClose(fd);
+}
+
+FILE* fopen(const char* path, const char* mode) {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("fopen()");
+    return midiRealFopen(path, mode);
+}
+
+int nanosleep(const struct timespec* duration, struct timespec* remaining) {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("nanosleep()");
+    return midiRealNanosleep(duration, remaining);
+}
+
+int usleep(useconds_t usec) {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("usleep()");
+    return midiRealUsleep(usec);
+}
+
+unsigned int sleep(unsigned int seconds) {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("sleep()");
+    return midiRealSleep(seconds);
+}
+
+int poll(struct pollfd* fds, nfds_t nfds, int timeout) {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("poll()");
+    return midiRealPoll(fds, nfds, timeout);
+}
+
+int select(int nfds, fd_set* readfds, fd_set* writefds, fd_set* exceptfds, struct timeval* timeout) {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("select()");
+    return midiRealSelect(nfds, readfds, writefds, exceptfds, timeout);
+}
+
+int sem_wait(sem_t* sem) {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("sem_wait()");
+    return midiRealSemWait(sem);
+}
+
+}  // extern "C"
+
+static inline void* midiRealtimeAlloc(size_t size) {
+    return __libc_malloc(size);
+}
+
+static inline void midiRealtimeFree(void* ptr) {
+    __libc_free(ptr);
+}
+#else
+static inline void* midiRealtimeAlloc(size_t size) {
+    return std::malloc(size);
+}
+
+static inline void midiRealtimeFree(void* ptr) {
+    std::free(ptr);
+}
+#endif
+
+void* operator new(size_t size) {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("operator new");
+
+    if (void* ptr = midiRealtimeAlloc(size ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    DISTRHO_NAMESPACE::RealtimeCheck::violation("operator new[]");
+
+    if (void* ptr = midiRealtimeAlloc(size ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr != nullptr)
+        DISTRHO_NAMESPACE::RealtimeCheck::violation("operator delete");
+
+    midiRealtimeFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    if (ptr != nullptr)
+        DISTRHO_NAMESPACE::RealtimeCheck::violation("operator delete[]");
+
+    midiRealtimeFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    operator delete[](ptr);
+}
+
+#endif  // MIDI_RT_CHECK
+
+#endif  // #ifndef MIDI_REALTIME_CHECK_H
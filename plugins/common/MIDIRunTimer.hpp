@@ -0,0 +1,387 @@
+/*
+ * Optional run() timing instrumentation for midiomatic plugins
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_RUN_TIMER_H
+#define MIDI_RUN_TIMER_H
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIUtils.hpp"
+
+#ifndef MIDI_RUN_TIMING
+#define MIDI_RUN_TIMING 0
+#endif
+
+#if MIDI_RUN_TIMING
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <time.h>
+#endif
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+#if MIDI_RUN_TIMING
+
+/**
+  Histogram of run() durations with power-of-two buckets: bucket n counts
+  durations of 2^n to 2^(n+1) - 1 nanoseconds.
+*/
+class RunTimeHistogram {
+public:
+    static constexpr uint32_t kBuckets = 32;
+
+    RunTimeHistogram() noexcept {
+        clear();
+    }
+
+    void clear() noexcept {
+        for (uint32_t i=0; i < kBuckets; i++)
+            fCounts[i] = 0;
+
+        fTotal = 0;
+        fMax = 0;
+    }
+
+    inline void add(uint64_t ns) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        uint32_t bucket = ns != 0 ? 63 - (uint32_t) __builtin_clzll(ns) : 0;
+#else
+        uint32_t bucket = 0;
+
+        while ((ns >> (bucket + 1)) != 0)
+            bucket++;
+#endif
+
+        if (bucket >= kBuckets)
+            bucket = kBuckets - 1;
+
+        fCounts[bucket]++;
+        fTotal++;
+
+        if (ns > fMax)
+            fMax = ns;
+    }
+
+    void merge(const RunTimeHistogram& other) noexcept {
+        for (uint32_t i=0; i < kBuckets; i++)
+            fCounts[i] += other.fCounts[i];
+
+        fTotal += other.fTotal;
+
+        if (other.fMax > fMax)
+            fMax = other.fMax;
+    }
+
+    uint64_t getTotal() const noexcept {
+        return fTotal;
+    }
+
+    uint64_t getMax() const noexcept {
+        return fMax;
+    }
+
+    /**
+      Return the upper bound in nanoseconds of the bucket, which contains
+      the @a p (0.0 - 1.0) quantile.
+    */
+    uint64_t getPercentile(double p) const noexcept {
+        const uint64_t rank = (uint64_t) (p * (double) fTotal);
+        uint64_t count = 0;
+
+        for (uint32_t i=0; i < kBuckets; i++) {
+            count += fCounts[i];
+
+            if (count > rank)
+                return ((uint64_t) 2 << i) - 1;
+        }
+
+        return fMax;
+    }
+
+private:
+    uint64_t fCounts[kBuckets];
+    uint64_t fTotal;
+    uint64_t fMax;
+};
+
+/**
+  Current time of a monotonic clock in nanoseconds.
+*/
+static inline uint64_t runTimerNow() noexcept {
+#if defined(CLOCK_MONOTONIC_RAW)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+#else
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+class RunTimingReporter;
+
+/**
+  Measures the duration of each run() of one plugin instance.
+
+  The audio thread collects durations in a histogram and every
+  kBlocksPerSnapshot blocks passes it through a lock-free single-producer,
+  single-consumer ring to the reporter thread. If the ring is full, the
+  snapshot is dropped and counted.
+*/
+class RunTimer {
+public:
+    static constexpr uint32_t kBlocksPerSnapshot = 256;
+    static constexpr uint32_t kRingSize = 8;
+
+    RunTimer();
+    ~RunTimer();
+
+    inline void start() noexcept {
+        fStart = runTimerNow();
+    }
+
+    inline void stop() noexcept {
+        fCurrent.add(runTimerNow() - fStart);
+
+        if (fCurrent.getTotal() < kBlocksPerSnapshot)
+            return;
+
+        const uint32_t tail = fTail.load(std::memory_order_relaxed);
+
+        if (tail - fHead.load(std::memory_order_acquire) < kRingSize) {
+            fRing[tail % kRingSize] = fCurrent;
+            fTail.store(tail + 1, std::memory_order_release);
+        }
+        else {
+            fDroppedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        fCurrent.clear();
+    }
+
+private:
+    friend class RunTimingReporter;
+
+    // Called by the reporter thread only
+    bool pop(RunTimeHistogram& histogram) noexcept {
+        const uint32_t head = fHead.load(std::memory_order_relaxed);
+
+        if (head == fTail.load(std::memory_order_acquire))
+            return false;
+
+        histogram = fRing[head % kRingSize];
+        fHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // audio thread
+    uint64_t fStart;
+    RunTimeHistogram fCurrent;
+
+    // shared
+    RunTimeHistogram fRing[kRingSize];
+    std::atomic<uint32_t> fHead;
+    char fPadding[CACHE_LINE_SIZE];
+    std::atomic<uint32_t> fTail;
+    std::atomic<uint32_t> fDroppedCount;
+
+    // reporter thread
+    uint32_t fId;
+    RunTimeHistogram fTotal;
+};
+
+/**
+  Process-wide thread, which collects the snapshots of all RunTimers once a
+  second and appends their accumulated percentiles to a log file, named by
+  the environment variable MIDIOMATIC_TIMING_LOG or
+  "/tmp/midiomatic-timing.log" by default.
+
+  Registering and unregistering timers takes a mutex, which the audio
+  thread never touches.
+*/
+class RunTimingReporter {
+public:
+    static RunTimingReporter& getInstance() {
+        static RunTimingReporter reporter;
+        return reporter;
+    }
+
+    void add(RunTimer* timer) {
+        std::lock_guard<std::mutex> lock(fMutex);
+
+        timer->fId = ++fLastId;
+        fTimers.push_back(timer);
+
+        if (!fThread.joinable())
+            fThread = std::thread(&RunTimingReporter::loop, this);
+    }
+
+    void remove(RunTimer* timer) {
+        std::lock_guard<std::mutex> lock(fMutex);
+
+        collect(timer);
+
+        for (size_t i=0; i < fTimers.size(); i++) {
+            if (fTimers[i] == timer) {
+                fTimers.erase(fTimers.begin() + i);
+                break;
+            }
+        }
+    }
+
+private:
+    RunTimingReporter()
+        : fLastId(0),
+          fQuit(false)
+    {
+        const char* path = std::getenv("MIDIOMATIC_TIMING_LOG");
+        fPath = path != nullptr ? path : "/tmp/midiomatic-timing.log";
+    }
+
+    ~RunTimingReporter() {
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            fQuit = true;
+        }
+
+        fCondition.notify_all();
+
+        if (fThread.joinable())
+            fThread.join();
+    }
+
+    void loop() {
+        std::unique_lock<std::mutex> lock(fMutex);
+
+        for (;;) {
+            fCondition.wait_for(lock, std::chrono::seconds(1));
+
+            for (size_t i=0; i < fTimers.size(); i++)
+                collect(fTimers[i]);
+
+            if (fQuit)
+                break;
+        }
+    }
+
+    // Called with the mutex held
+    void collect(RunTimer* timer) {
+        RunTimeHistogram histogram;
+        bool changed = false;
+
+        while (timer->pop(histogram)) {
+            timer->fTotal.merge(histogram);
+            changed = true;
+        }
+
+        if (!changed)
+            return;
+
+        const RunTimeHistogram& total(timer->fTotal);
+
+        if (FILE* file = std::fopen(fPath, "a")) {
+            std::fprintf(file, "%s #%u: blocks=%llu p50<=%lluns p90<=%lluns p99<=%lluns "
+                         "p99.9<=%lluns max=%lluns dropped=%u\n",
+                         DISTRHO_PLUGIN_NAME, timer->fId,
+                         (unsigned long long) total.getTotal(),
+                         (unsigned long long) total.getPercentile(0.5),
+                         (unsigned long long) total.getPercentile(0.9),
+                         (unsigned long long) total.getPercentile(0.99),
+                         (unsigned long long) total.getPercentile(0.999),
+                         (unsigned long long) total.getMax(),
+                         timer->fDroppedCount.load(std::memory_order_relaxed));
+            std::fclose(file);
+        }
+    }
+
+    const char* fPath;
+    std::vector<RunTimer*> fTimers;
+    uint32_t fLastId;
+    bool fQuit;
+    std::mutex fMutex;
+    std::condition_variable fCondition;
+    std::thread fThread;
+};
+
+inline RunTimer::RunTimer()
+    : fStart(0),
+      fHead(0),
+      fTail(0),
+      fDroppedCount(0),
+      fId(0)
+{
+    static_assert(offsetof(RunTimer, fTail) - offsetof(RunTimer, fHead) >= CACHE_LINE_SIZE,
+                  "producer and consumer index share a cache line");
+    RunTimingReporter::getInstance().add(this);
+}
+
+inline RunTimer::~RunTimer() {
+    RunTimingReporter::getInstance().remove(this);
+}
+
+#else  // MIDI_RUN_TIMING
+
+// Timing disabled: compiles to nothing
+class RunTimer {
+public:
+    inline void start() noexcept {}
+    inline void stop() noexcept {}
+};
+
+#endif  // MIDI_RUN_TIMING
+
+/**
+  Times the enclosing scope, e.g. the body of run(), with @a timer.
+*/
+class RunTimerScope {
+public:
+    explicit RunTimerScope(RunTimer& timer) noexcept
+        : fTimer(timer)
+    {
+        fTimer.start();
+    }
+
+    ~RunTimerScope() noexcept {
+        fTimer.stop();
+    }
+
+private:
+    RunTimer& fTimer;
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_RUN_TIMER_H
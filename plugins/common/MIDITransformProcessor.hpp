@@ -0,0 +1,227 @@
+/*
+ * Common base class for midiomatic MIDI converter processors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_TRANSFORM_PROCESSOR_H
+#define MIDI_TRANSFORM_PROCESSOR_H
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIConfigSnapshot.hpp"
+#include "MIDIEventClassifier.hpp"
+#include "MIDIProcessor.hpp"
+#include "MIDIUtils.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Base class for processors, which convert one kind of channel message.
+
+  It owns the parts all converters share: the "Filter Channel" and "Keep
+  original" parameters, passing through of non-matching events and the
+  processing loop. With a filter channel set, incoming events are
+  pre-classified by status type and channel, otherwise the status type is
+  tested per event, and for each matching event Derived::transform() is called,
+  which is bound at compile time, so the compiler can inline it into the loop:
+
+      template <class Sink> bool transform(const MidiEvent& event, const Config& config, Sink& out);
+
+  It writes any generated events to @a out and returns true if it converted
+  the event, in which case the original is only passed on if "Keep original"
+  is on, or false to pass it through unchanged.
+
+  Derived classes store a parameter value in
+
+      void storeParameter(uint32_t index, float value);
+
+  and derive the settings transform() works with from all parameters in
+
+      bool updateConfig(Config& config) const;
+
+  which returns false if transform() would never convert an event with this
+  configuration. The configuration, the classifier and the bypass flag are
+  published together as one snapshot after each parameter change (or
+  after all parameters of a preset, with setParameterValues()), so run()
+  always uses a consistent set of them for a whole block.
+*/
+template <class Derived, class Config>
+class MidiTransformProcessor : public MidiProcessor {
+public:
+    MidiTransformProcessor(uint8_t statusType)
+        : fStatusType(statusType),
+          fFilterChannel(-1),
+          fKeepOriginal(false) {}
+
+    void setParameterValue(uint32_t index, float value) override {
+        static_cast<Derived*>(this)->storeParameter(index, value);
+        publish();
+    }
+
+    void setParameterValues(const float* values) override {
+        Derived* const self = static_cast<Derived*>(this);
+
+        for (uint32_t i=0; i < getParameterCount(); i++)
+            self->storeParameter(i, values[i]);
+
+        publish();
+    }
+
+    template <class Sink>
+    void run(const MidiEvent* events, uint32_t eventCount, Sink& out) {
+        const State& state = fState.read();
+
+        if (state.bypass)
+            forward(events, eventCount, out);
+        else
+            runKernel(state, events, eventCount, out);
+    }
+
+    void process(const MidiEvent* events, uint32_t eventCount, MidiEventBuffer& out) override {
+        run(events, eventCount, out);
+    }
+
+protected:
+    // -------------------------------------------------------------------
+    // Common parameters
+
+    static void initFilterChannelParameter(Parameter& parameter) {
+        parameter.hints = kParameterIsAutomable | kParameterIsInteger;
+        parameter.name = "Filter Channel";
+        parameter.symbol = "channelf";
+        parameter.ranges.def = 0;
+        parameter.ranges.min = 0;
+        parameter.ranges.max = 16;
+        parameter.enumValues.restrictedMode = true;
+        setEnumValues(parameter.enumValues, paramEnumFilterChannels);
+    }
+
+    static void initKeepOriginalParameter(Parameter& parameter, const char* name, const char* shortName) {
+        parameter.hints = kParameterIsAutomable | kParameterIsInteger | kParameterIsBoolean;
+        parameter.name = name;
+        parameter.shortName = shortName;
+        parameter.symbol = "keep_original";
+        parameter.ranges.def = 0;
+        parameter.ranges.min = 0;
+        parameter.ranges.max = 1;
+    }
+
+    /**
+      Set the filter channel (0 = any, 1-16) and return the clamped value.
+    */
+    float setFilterChannel(float value) {
+        value = clamp(value, 0.0f, 16.0f);
+        fFilterChannel = (int8_t) value - 1;
+        return value;
+    }
+
+    /**
+      Set whether converted events are kept and return the clamped value.
+    */
+    float setKeepOriginal(float value) {
+        value = clamp(value, 0.0f, 1.0f);
+        fKeepOriginal = (bool) value;
+        return value;
+    }
+
+    int8_t getFilterChannel() const noexcept {
+        return fFilterChannel;
+    }
+
+    // -------------------------------------------------------------------
+
+private:
+    struct State {
+        bool bypass;
+        bool keepOriginal;
+        bool classify;
+        MidiEventClassifier classifier;
+        Config config;
+    };
+
+    /**
+      Build the snapshot for the current parameters and pass it to run().
+      If transform() is idle and originals are kept as well, run() forwards
+      events without decoding.
+    */
+    void publish() {
+        State& state = fState.edit();
+        const bool active = static_cast<const Derived*>(this)->updateConfig(state.config);
+
+        state.bypass = !active && fKeepOriginal;
+        state.keepOriginal = fKeepOriginal;
+        // Skipping non-matching runs only pays off if the channel filter thins them out
+        state.classify = fFilterChannel >= 0;
+
+        state.classifier.clear();
+        state.classifier.addMatch(fStatusType, fFilterChannel);
+        fState.publish();
+    }
+
+    template <class Sink>
+    static inline void forward(const MidiEvent* events, uint32_t count, Sink& out) {
+        for (uint32_t i=0; i<count; ++i)
+            out.write(events[i]);
+    }
+
+    template <class Sink>
+    void runKernel(const State& state, const MidiEvent* events, uint32_t eventCount, Sink& out) {
+        Derived* const self = static_cast<Derived*>(this);
+        const Config& config = state.config;
+        const bool keepOriginal = state.keepOriginal;
+
+        if (!state.classify) {
+            for (uint32_t i=0; i<eventCount; ++i) {
+                const MidiEvent& event = events[i];
+
+                if (event.size > MidiEvent::kDataSize || (event.data[0] & 0xF0) != fStatusType
+                        || !self->transform(event, config, out) || keepOriginal)
+                    out.write(event);
+            }
+
+            return;
+        }
+
+        dispatchMidiEvents(state.classifier, events, eventCount,
+            [&out](const MidiEvent* run, uint32_t count) {
+                forward(run, count, out);
+            },
+            [self, &config, keepOriginal, &out](const MidiEvent& event) {
+                if (!self->transform(event, config, out) || keepOriginal)
+                    out.write(event);
+            });
+    }
+
+    const uint8_t fStatusType;
+    int8_t fFilterChannel;
+    bool fKeepOriginal;
+    ConfigSnapshot<State> fState;
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_TRANSFORM_PROCESSOR_H
@@ -0,0 +1,165 @@
+/*
+ * MIDI constants and value helpers shared by midiomatic plugins
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_UTILS_H
+#define MIDI_UTILS_H
+
+#include "DistrhoPlugin.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+// MIDI message status bytes
+
+constexpr uint8_t MIDI_NOTE_OFF = 0x80;
+constexpr uint8_t MIDI_NOTE_ON = 0x90;
+constexpr uint8_t MIDI_POLY_PRESSURE = 0xA0;
+constexpr uint8_t MIDI_CONTROL_CHANGE = 0xB0;
+constexpr uint8_t MIDI_PROGRAM_CHANGE = 0xC0;
+constexpr uint8_t MIDI_CHANNEL_PRESSURE = 0xD0;
+constexpr uint8_t MIDI_PITCH_BEND = 0xE0;
+
+constexpr uint8_t MIDI_SYSTEM_EXCLUSIVE = 0xF0;
+constexpr uint8_t MIDI_MTC_QUARTER_FRAME = 0xF1;
+constexpr uint8_t MIDI_SONG_POSITION_POINTER = 0xF2;
+constexpr uint8_t MIDI_SONG_SELECT = 0xF3;
+constexpr uint8_t MIDI_UNDEFINED_F4 = 0xF4;
+constexpr uint8_t MIDI_UNDEFINED_F5 = 0xF5;
+constexpr uint8_t MIDI_TUNE_REQUEST = 0xF6;
+constexpr uint8_t MIDI_END_OF_EXCLUSIVE = 0xF7;
+constexpr uint8_t MIDI_TIMING_CLOCK = 0xF8;
+constexpr uint8_t MIDI_UNDEFINED_F9 = 0xF9;
+constexpr uint8_t MIDI_START = 0xFA;
+constexpr uint8_t MIDI_CONTINUE = 0xFB;
+constexpr uint8_t MIDI_STOP = 0xFC;
+constexpr uint8_t MIDI_UNDEFINED_FD = 0xFD;
+constexpr uint8_t MIDI_ACTIVE_SENSING = 0xFE;
+constexpr uint8_t MIDI_SYSTEM_RESET = 0xFF;
+
+constexpr uint8_t NUM_CHANNELS = 16;
+constexpr uint8_t NUM_CONTROLLERS = 128;
+
+// -----------------------------------------------------------------------
+// Memory layout
+
+/**
+  Assumed size of a CPU cache line. Data written by different threads, or by
+  different plugin instances, is kept at least this far apart, so that the
+  threads do not invalidate each other's cache lines (false sharing).
+*/
+constexpr uint32_t CACHE_LINE_SIZE = 64;
+
+// -----------------------------------------------------------------------
+// Value helpers
+
+/**
+  Return whether @a v lies within @a min .. @a max (inclusive).
+  If @a min > @a max, return whether @a v lies *outside* of @a max .. @a min
+  (bounds still included).
+*/
+template <typename T>
+constexpr bool inRange(T v, T min, T max) {
+    return min <= max ? (v >= min && v <= max) : (v >= min || v <= max);
+}
+
+/**
+  Limit @a v to @a min .. @a max.
+*/
+template <typename T>
+constexpr T clamp(T v, T min, T max) {
+    return v < min ? min : (v > max ? max : v);
+}
+
+/**
+  Map @a v linearly from range @a imin .. @a imax to @a omin .. @a omax.
+  With integer types the result is truncated toward zero.
+  An empty input range maps everything to @a omin.
+*/
+template <typename T>
+constexpr T mapRange(T v, T imin, T imax, T omin, T omax) {
+    return imax == imin ? omin : (v - imin) * (omax - omin) / (imax - imin) + omin;
+}
+
+// -----------------------------------------------------------------------
+// Parameter helpers
+
+static inline void assignEnumValues(const ParameterEnumerationValue*& values,
+                                    const ParameterEnumerationValue* list) noexcept {
+    values = list;
+}
+
+// Upstream DPF declares the pointer non-const, but never writes through it
+static inline void assignEnumValues(ParameterEnumerationValue*& values,
+                                    const ParameterEnumerationValue* list) noexcept {
+    values = const_cast<ParameterEnumerationValue*>(list);
+}
+
+/**
+  Point @a pev at @a list without copying it, if this DPF version has
+  ParameterEnumerationValues::deleteLater, i.e. upstream DPF or the one
+  patched with patches/dpf/parameter-enum-static-values.patch.
+*/
+template <class Values>
+static inline auto shareEnumValues(Values& pev, const ParameterEnumerationValue* list, int)
+    -> decltype(pev.deleteLater = false, void()) {
+    assignEnumValues(pev.values, list);
+    pev.deleteLater = false;
+}
+
+/**
+  Older DPF versions always delete[] the values with the parameter, so they
+  get a copy on the heap.
+*/
+template <class Values>
+static inline void shareEnumValues(Values& pev, const ParameterEnumerationValue* list, long) {
+    ParameterEnumerationValue* values = new ParameterEnumerationValue[pev.count];
+
+    for (uint32_t i=0; i < pev.count; i++)
+        values[i] = list[i];
+
+    pev.values = values;
+}
+
+/**
+  Let @a pev use the static enumeration value table @a list.
+
+  If DPF supports it, the table is not copied, so all parameters and plugin
+  instances using it share the same values and labels, and DPF does not
+  delete it with the parameter. Otherwise each parameter gets its own copy.
+*/
+template <size_t N>
+static inline void setEnumValues(ParameterEnumerationValues& pev,
+                                 const ParameterEnumerationValue(& list)[N]) {
+    static_assert(N <= 255, "too many enumeration values");
+    pev.count = N;
+    shareEnumValues(pev, list, 0);
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_UTILS_H
@@ -0,0 +1,35 @@
+#!/usr/bin/make -f
+# Makefile settings shared by all midiomatic plugins #
+# -------------------------------------------------- #
+# Created by Christopher Arndt
+#
+# Include this after dpf/Makefile.plugins.mk (or Makefile.base.mk).
+#
+
+# --------------------------------------------------------------
+# Shared headers
+
+BUILD_CXX_FLAGS += -I../common
+
+# --------------------------------------------------------------
+# Optional run() timing instrumentation (make RUN_TIMING=true)
+
+ifeq ($(RUN_TIMING),true)
+BUILD_CXX_FLAGS += -DMIDI_RUN_TIMING=1
+LINK_FLAGS += -pthread
+endif
+
+# --------------------------------------------------------------
+# Optional USDT probes (make USDT=true), needs <sys/sdt.h>
+
+ifeq ($(USDT),true)
+BUILD_CXX_FLAGS += -DMIDI_USDT=1
+endif
+
+# --------------------------------------------------------------
+# Realtime-safety checks for debugging (make RT_CHECK=true)
+
+ifeq ($(RT_CHECK),true)
+BUILD_CXX_FLAGS += -DMIDI_RT_CHECK=1
+LINK_FLAGS += -ldl -Wl,-Bsymbolic-functions
+endif
@@ -0,0 +1,225 @@
+/*
+ * Reference kernels for midiomatic benchmarks
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef MIDI_BENCH_REFERENCE_H
+#define MIDI_BENCH_REFERENCE_H
+
+#include <cstring>
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIUtils.hpp"
+
+#include "../plugins/MIDIPBToCC/MIDIPBToCCProcessor.hpp"
+#include "../plugins/MIDICCMapX4/MIDICCMapX4Processor.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/*
+  The helper macros the plugins defined before MIDIUtils.hpp replaced them,
+  renamed so they don't clash with system headers.
+*/
+#define REF_IN_RANGE(v, min, max) ((min) <= (max) ? ((v) >= (min) && (v) <= (max)) : ((v) >= (min) || (v) <= (max)))
+#define REF_MAP(v, imin, imax, omin, omax) (((v) - (imin)) * ((omax) - (omin)) / ((imax) - (imin)) + (omin))
+
+// -----------------------------------------------------------------------
+
+/*
+  The processing loops of MIDI PB to CC and MIDI CC Map X4 as they were
+  before the run() kernels were specialized on the parameters: every event
+  is decoded and the channel filter, the PB range direction, "keep original"
+  and the destination modes are tested per event. They only exist to measure
+  the specialized kernels against and take their parameters from a
+  configured processor.
+*/
+
+class MidiPBToCCReference {
+public:
+    typedef MidiPBToCCProcessor P;
+
+    explicit MidiPBToCCReference(const MidiProcessor& processor) {
+        for (uint32_t i=0; i < P::paramCount; i++)
+            fParams[i] = processor.getParameterValue(i);
+
+        filterChannel = (int8_t) fParams[P::paramFilterChannel] - 1;
+    }
+
+    template <class Sink>
+    void run(const MidiEvent* events, uint32_t eventCount, Sink& out) {
+        bool pass;
+        uint8_t chan;
+        int16_t pb_value,
+                pb_min = (int16_t) fParams[P::paramPBMin],
+                pb_max = (int16_t) fParams[P::paramPBMax];
+        struct MidiEvent cc_event;
+
+        for (uint32_t i=0; i<eventCount; ++i) {
+            pass = true;
+
+            if ((events[i].data[0] & 0xF0) != MIDI_PITCH_BEND) {
+                out.write(events[i]);
+                continue;
+            }
+
+            chan = events[i].data[0] & 0x0F;
+
+            if (filterChannel == -1 || chan == filterChannel) {
+                pb_value = (((events[i].data[2] & 0x7f) << 7) | (events[i].data[1] & 0x7f)) - 8192;
+
+                if (inRange(pb_value, pb_min, pb_max)) {
+                    pass = (bool) fParams[P::paramKeepOriginal];
+                    cc_event.frame = events[i].frame;
+                    cc_event.size = 3;
+                    cc_event.data[0] = MIDI_CONTROL_CHANGE | chan;
+
+                    if (pb_value >= 0) {
+                        cc_event.data[1] = (uint8_t) fParams[P::paramCC1];
+
+                        if (pb_min <= pb_max)
+                            cc_event.data[2] = ((uint8_t) mapRange<float>(pb_value, 0, pb_max, fParams[P::paramCC1Min], fParams[P::paramCC1Max])) & 0x7f;
+                        else
+                            cc_event.data[2] = ((uint8_t) mapRange<float>(pb_value, pb_min, 8191, fParams[P::paramCC1Min], fParams[P::paramCC1Max])) & 0x7f;
+                    }
+                    else {
+                        cc_event.data[1] = (uint8_t) fParams[P::paramCC2];
+
+                        if (pb_min <= pb_max)
+                            cc_event.data[2] = ((uint8_t) mapRange<float>(pb_value, -1, pb_min, fParams[P::paramCC2Min], fParams[P::paramCC2Max])) & 0x7f;
+                        else
+                            cc_event.data[2] = ((uint8_t) mapRange<float>(pb_value, pb_max, -8192, fParams[P::paramCC2Min], fParams[P::paramCC2Max])) & 0x7f;
+                    }
+
+                    out.write(cc_event);
+                }
+            }
+
+            if (pass)
+                out.write(events[i]);
+        }
+    }
+
+private:
+    float fParams[P::paramCount];
+    int8_t filterChannel;
+};
+
+class MidiCCMapX4Reference {
+public:
+    typedef MidiCCMapX4Processor P;
+
+    explicit MidiCCMapX4Reference(const MidiProcessor& processor) {
+        for (uint32_t i=0; i < P::paramCount; i++)
+            fParams[i] = processor.getParameterValue(i);
+
+        filterChannel = (int8_t) fParams[P::paramFilterChannel] - 1;
+        std::memset(lastCCValue, -1, sizeof(lastCCValue));
+    }
+
+    template <class Sink>
+    void run(const MidiEvent* events, uint32_t eventCount, Sink& out) {
+        bool pass;
+        uint8_t chan, cc_mode, cc_dest, cc_end, cc_min, cc_max, cc_no_dups,
+                cc_num, cc_start, cc_val, new_val, param_offset;
+        int8_t cc_chan;
+        uint8_t cc_src = (uint8_t) fParams[P::paramCCSource];
+        struct MidiEvent cc_event;
+
+        for (uint32_t i=0; i<eventCount; ++i) {
+            pass = true;
+
+            if ((events[i].data[0] & 0xF0) != MIDI_CONTROL_CHANGE) {
+                out.write(events[i]);
+                continue;
+            }
+
+            chan = events[i].data[0] & 0x0F;
+            cc_num = events[i].data[1] & 0x7f;
+
+            if ((filterChannel == -1 || chan == filterChannel) && cc_num == cc_src) {
+                pass = (bool) fParams[P::paramKeepOriginal];
+                cc_val = events[i].data[2] & 0x7f;
+
+                for (int dest=0; dest<4; dest++) {
+                    param_offset = P::paramCC1Mode + (8 * dest);
+                    cc_mode = (uint8_t) fParams[param_offset];
+                    cc_dest = (uint8_t) fParams[param_offset + 1];
+                    cc_chan = (int8_t) fParams[param_offset + 2] - 1;
+                    cc_no_dups = (bool) fParams[param_offset + 3];
+                    cc_start = (uint8_t) fParams[param_offset + 4];
+                    cc_end = (uint8_t) fParams[param_offset + 5];
+                    cc_min = (uint8_t) fParams[param_offset + 6];
+                    cc_max = (uint8_t) fParams[param_offset + 7];
+
+                    if (inRange(cc_val, cc_start, cc_end)) {
+                        switch (cc_mode) {
+                            case 1:
+                                new_val = (uint8_t) mapRange<int32_t>(cc_val, cc_start, cc_end, cc_min, cc_max);
+                                break;
+                            case 2:
+                                new_val = (uint8_t) mapRange<int32_t>(cc_val, 0, 127, cc_min, cc_max);
+                                break;
+                            default:
+                                continue;
+                        }
+
+                        if (cc_chan == -1)
+                            cc_chan = chan;
+
+                        if (cc_no_dups && new_val == lastCCValue[cc_chan][cc_dest])
+                            continue;
+
+                        cc_event.frame = events[i].frame;
+                        cc_event.size = 3;
+                        cc_event.data[0] = MIDI_CONTROL_CHANGE | cc_chan;
+                        cc_event.data[1] = cc_dest;
+                        cc_event.data[2] = new_val;
+                        lastCCValue[cc_chan][cc_dest] = new_val;
+                        out.write(cc_event);
+                    }
+                }
+
+                if (pass)
+                    out.write(events[i]);
+            }
+            else {
+                out.write(events[i]);
+            }
+        }
+    }
+
+private:
+    float fParams[P::paramCount];
+    int8_t filterChannel;
+    int8_t lastCCValue[16][128];
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_BENCH_REFERENCE_H
@@ -0,0 +1,314 @@
+/*
+ * Benchmark helpers for midiomatic tools
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef MIDI_BENCHMARK_H
+#define MIDI_BENCHMARK_H
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "DistrhoPlugin.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Seconds since an arbitrary point, from a monotonic clock.
+*/
+static inline double benchNow() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+  Small xorshift random number generator, so every run of a benchmark
+  generates the same events.
+*/
+class BenchRandom {
+public:
+    explicit BenchRandom(uint32_t seed = 0x12345678) noexcept
+        : fState(seed != 0 ? seed : 1) {}
+
+    inline uint32_t next() noexcept {
+        fState ^= fState << 13;
+        fState ^= fState >> 17;
+        fState ^= fState << 5;
+        return fState;
+    }
+
+    /**
+      Return a number in 0 .. @a n - 1.
+    */
+    inline uint32_t below(uint32_t n) noexcept {
+        return (uint32_t) (((uint64_t) next() * n) >> 32);
+    }
+
+private:
+    uint32_t fState;
+};
+
+/**
+  Output sink for the processors' run(), which counts the events and folds
+  their bytes into a checksum, so the compiler can't drop the work and two
+  runs can be compared.
+*/
+struct BenchSink {
+    uint64_t count;
+    uint64_t checksum;
+
+    BenchSink() noexcept
+        : count(0), checksum(0) {}
+
+    inline bool write(const MidiEvent& event) noexcept {
+        uint32_t word = event.size;
+
+        // SysEx data is not hashed, bytes beyond the size may be undefined
+        if (event.size <= MidiEvent::kDataSize) {
+            std::memcpy(&word, event.data, sizeof(word));
+            word &= event.size < 4 ? (1u << (8 * event.size)) - 1 : 0xFFFFFFFFu;
+        }
+
+        checksum = (checksum ^ word ^ ((uint64_t) event.frame << 32)) * 0x100000001B3ull;
+        count++;
+        return true;
+    }
+
+    void clear() noexcept {
+        count = checksum = 0;
+    }
+};
+
+/**
+  Fill @a events with @a count channel messages on random channels, spread
+  over blocks of @a blockFrames frames with @a blockEvents events each.
+  About @a percent percent of them are of @a statusType with data byte 1 set
+  to @a data1 (or random, if @a data1 > 127), the others are notes and
+  controllers.
+*/
+static inline void makeBenchEvents(std::vector<MidiEvent>& events, uint32_t count, uint32_t blockEvents,
+                                   uint32_t blockFrames, uint8_t statusType, uint8_t data1, uint32_t percent,
+                                   BenchRandom& random) {
+    events.resize(count);
+
+    for (uint32_t i=0; i < count; i++) {
+        MidiEvent& ev(events[i]);
+        const uint8_t channel = (uint8_t) random.below(16);
+
+        ev.frame = (i % blockEvents) * blockFrames / blockEvents;
+        ev.size = 3;
+        ev.dataExt = nullptr;
+
+        if (random.below(100) < percent) {
+            ev.data[0] = statusType | channel;
+            ev.data[1] = data1 > 127 ? (uint8_t) random.below(128) : data1;
+        }
+        else {
+            static const uint8_t others[] = {0x90, 0x80, 0xB0};
+
+            ev.data[0] = others[random.below(3)] | channel;
+            ev.data[1] = (uint8_t) random.below(128);
+        }
+
+        ev.data[2] = (uint8_t) random.below(128);
+        ev.data[3] = 0;
+    }
+}
+
+// -----------------------------------------------------------------------
+
+/**
+  Hardware performance counters of the calling thread: instructions,
+  branches and mispredicted branches, read with perf_event_open() on Linux.
+  Where this is not available (or not permitted, see
+  /proc/sys/kernel/perf_event_paranoid), isAvailable() returns false and
+  only times are reported.
+*/
+class BenchCounters {
+public:
+    enum Counter {
+        kInstructions,
+        kBranches,
+        kBranchMisses,
+        kCount
+    };
+
+    BenchCounters() noexcept
+        : fAvailable(false)
+    {
+        for (int i=0; i < kCount; i++) {
+            fFds[i] = -1;
+            fValues[i] = 0;
+        }
+
+#ifdef __linux__
+        static const uint64_t configs[kCount] = {
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+            PERF_COUNT_HW_BRANCH_MISSES
+        };
+
+        fAvailable = true;
+
+        for (int i=0; i < kCount; i++) {
+            struct perf_event_attr attr;
+
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+
+            fFds[i] = (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+
+            if (fFds[i] < 0)
+                fAvailable = false;
+        }
+#endif
+    }
+
+    ~BenchCounters() {
+#ifdef __linux__
+        for (int i=0; i < kCount; i++) {
+            if (fFds[i] >= 0)
+                close(fFds[i]);
+        }
+#endif
+    }
+
+    bool isAvailable() const noexcept {
+        return fAvailable;
+    }
+
+    void start() noexcept {
+#ifdef __linux__
+        if (!fAvailable)
+            return;
+
+        for (int i=0; i < kCount; i++) {
+            ioctl(fFds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fFds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void stop() noexcept {
+#ifdef __linux__
+        if (!fAvailable)
+            return;
+
+        for (int i=0; i < kCount; i++) {
+            ioctl(fFds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+            if (read(fFds[i], &fValues[i], sizeof(fValues[i])) != sizeof(fValues[i]))
+                fValues[i] = 0;
+        }
+#endif
+    }
+
+    /**
+      Return the value of @a counter between the last start() and stop().
+    */
+    uint64_t get(Counter counter) const noexcept {
+        return fValues[counter];
+    }
+
+private:
+    int fFds[kCount];
+    uint64_t fValues[kCount];
+    bool fAvailable;
+};
+
+/**
+  Result of timing a kernel, per input event.
+*/
+struct BenchResult {
+    double nsPerEvent;
+    double instructionsPerEvent;
+    double branchesPerEvent;
+    double branchMissesPerEvent;
+    uint64_t eventsOut;
+    uint64_t checksum;
+
+    BenchResult() noexcept
+        : nsPerEvent(0.0), instructionsPerEvent(0.0), branchesPerEvent(0.0),
+          branchMissesPerEvent(0.0), eventsOut(0), checksum(0) {}
+};
+
+/**
+  Run @a kernel over @a events in blocks of @a blockEvents events,
+  @a repeat times, and return the figures of the fastest pass. @a kernel
+  must have a template method run(events, count, sink).
+*/
+template <class Kernel>
+static BenchResult benchKernel(Kernel& kernel, const std::vector<MidiEvent>& events, uint32_t blockEvents,
+                               uint32_t repeat, BenchCounters& counters) {
+    BenchResult best;
+    double bestSeconds = 0.0;
+    const uint32_t count = (uint32_t) events.size();
+
+    for (uint32_t r=0; r < repeat; r++) {
+        BenchSink sink;
+
+        counters.start();
+        const double start = benchNow();
+
+        for (uint32_t i=0; i < count; i += blockEvents)
+            kernel.run(events.data() + i, count - i < blockEvents ? count - i : blockEvents, sink);
+
+        const double seconds = benchNow() - start;
+        counters.stop();
+
+        if (r == 0 || seconds < bestSeconds) {
+            bestSeconds = seconds;
+            best.nsPerEvent = 1e9 * seconds / count;
+            best.instructionsPerEvent = (double) counters.get(BenchCounters::kInstructions) / count;
+            best.branchesPerEvent = (double) counters.get(BenchCounters::kBranches) / count;
+            best.branchMissesPerEvent = (double) counters.get(BenchCounters::kBranchMisses) / count;
+        }
+
+        best.eventsOut = sink.count;
+        best.checksum = sink.checksum;
+    }
+
+    return best;
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_BENCHMARK_H
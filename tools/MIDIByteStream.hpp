@@ -0,0 +1,368 @@
+/*
+ * Raw MIDI byte stream parsing and encoding for midiomatic tools
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_BYTE_STREAM_H
+#define MIDI_BYTE_STREAM_H
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIProcessor.hpp"
+#include "MIDIToolProcessors.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Parses a raw MIDI byte stream, e.g. from a serial port or a raw MIDI
+  device, into complete messages.
+
+  Running status is resolved, so every message passed on has its status byte.
+  Real-Time messages (0xF8-0xFF) may appear anywhere, also inside other
+  messages, and are passed on at once. SysEx messages are collected in a
+  fixed buffer, longer ones are dropped. Data bytes without a status and
+  undefined status bytes are ignored. Nothing is allocated after
+  construction.
+*/
+class MidiByteStreamParser {
+public:
+    static constexpr uint32_t kMaxSysExSize = 4096;
+
+    MidiByteStreamParser() noexcept
+        : fRunningStatus(0), fCount(0), fExpected(0), fSysExSize(0),
+          fInSysEx(false), fDroppedCount(0) {}
+
+    /**
+      Parse @a size bytes at @a data and call @a handle(data, size) for each
+      complete message. The data passed is only valid during the call.
+    */
+    template <class Handle>
+    void parse(const uint8_t* data, size_t size, Handle handle) {
+        for (size_t i=0; i < size; i++) {
+            const uint8_t byte = data[i];
+
+            if (byte >= 0xF8) {
+                // Real-Time messages don't affect running status or SysEx
+                if (byte != 0xF9 && byte != 0xFD)
+                    handle(&data[i], 1);
+            }
+            else if (byte >= 0x80) {
+                if (fInSysEx) {
+                    fInSysEx = false;
+
+                    if (byte == 0xF7 && fSysExSize < kMaxSysExSize) {
+                        fSysEx[fSysExSize++] = 0xF7;
+                        handle(fSysEx, fSysExSize);
+                        continue;
+                    }
+
+                    // too long or not terminated
+                    ++fDroppedCount;
+                }
+
+                statusByte(byte, handle);
+            }
+            else if (fInSysEx) {
+                if (fSysExSize < kMaxSysExSize)
+                    fSysEx[fSysExSize] = byte;
+
+                // keep counting, so the message is dropped when too long
+                if (fSysExSize <= kMaxSysExSize)
+                    fSysExSize++;
+            }
+            else if (fExpected > 0) {
+                if (fCount == 0) {
+                    // running status
+                    fMessage[0] = fRunningStatus;
+                    fCount = 1;
+                }
+
+                fMessage[fCount++] = byte;
+
+                if (fCount == fExpected) {
+                    handle(fMessage, fCount);
+                    fCount = 0;
+
+                    if (fRunningStatus == 0)
+                        fExpected = 0;
+                }
+            }
+        }
+    }
+
+    /**
+      Return the number of SysEx messages dropped because they were longer
+      than kMaxSysExSize or interrupted by another status byte.
+    */
+    uint32_t getDroppedCount() const noexcept {
+        return fDroppedCount;
+    }
+
+private:
+    template <class Handle>
+    void statusByte(uint8_t status, Handle& handle) {
+        fCount = 0;
+        fExpected = 0;
+
+        if (status < 0xF0) {
+            fRunningStatus = status;
+            fExpected = (status & 0xF0) == 0xC0 || (status & 0xF0) == 0xD0 ? 2 : 3;
+            return;
+        }
+
+        // System Common messages cancel running status
+        fRunningStatus = 0;
+
+        switch (status) {
+            case 0xF0:
+                fInSysEx = true;
+                fSysEx[0] = 0xF0;
+                fSysExSize = 1;
+                break;
+            case 0xF1:
+            case 0xF3:
+                fMessage[0] = status;
+                fCount = 1;
+                fExpected = 2;
+                break;
+            case 0xF2:
+                fMessage[0] = status;
+                fCount = 1;
+                fExpected = 3;
+                break;
+            case 0xF6:
+                fMessage[0] = status;
+                handle(fMessage, 1);
+                break;
+            default:
+                // 0xF4, 0xF5 and a stray 0xF7
+                break;
+        }
+    }
+
+    uint8_t fRunningStatus;
+    uint8_t fMessage[3];
+    uint8_t fCount;
+    uint8_t fExpected;
+    uint32_t fSysExSize;
+    bool fInSysEx;
+    uint32_t fDroppedCount;
+    uint8_t fSysEx[kMaxSysExSize];
+};
+
+// -----------------------------------------------------------------------
+
+/**
+  Writes MIDI events as a raw byte stream to a file descriptor, leaving out
+  status bytes where running status allows it.
+
+  The bytes are collected in a fixed buffer, which is written with flush()
+  or when it is full.
+*/
+class MidiByteStreamWriter {
+public:
+    static constexpr uint32_t kBufferSize = 4096;
+
+    explicit MidiByteStreamWriter(int fd) noexcept
+        : fFile(fd), fSize(0), fRunningStatus(0), fError(false) {}
+
+    void write(const MidiEvent& event) {
+        const uint8_t* data = event.size > MidiEvent::kDataSize ? event.dataExt : event.data;
+
+        if (event.size == 0)
+            return;
+
+        if (data[0] >= 0xF8) {
+            // Real-Time messages may go between running status messages
+            putBytes(data, 1);
+        }
+        else if (data[0] >= 0xF0) {
+            fRunningStatus = 0;
+            putBytes(data, event.size);
+        }
+        else if (data[0] == fRunningStatus) {
+            putBytes(data + 1, event.size - 1);
+        }
+        else {
+            fRunningStatus = data[0];
+            putBytes(data, event.size);
+        }
+    }
+
+    /**
+      Write all buffered bytes. Returns false if writing failed.
+    */
+    bool flush() {
+        uint32_t pos = 0;
+
+        while (pos < fSize && !fError) {
+            const ssize_t written = ::write(fFile, fBuffer + pos, fSize - pos);
+
+            if (written > 0)
+                pos += (uint32_t) written;
+            else if (written < 0 && errno != EINTR)
+                fError = true;
+        }
+
+        fSize = 0;
+        return !fError;
+    }
+
+    bool hasError() const noexcept {
+        return fError;
+    }
+
+private:
+    void putBytes(const uint8_t* data, uint32_t size) {
+        while (size > 0) {
+            if (fSize == kBufferSize)
+                flush();
+
+            const uint32_t count = size < kBufferSize - fSize ? size : kBufferSize - fSize;
+
+            std::memcpy(fBuffer + fSize, data, count);
+            fSize += count;
+            data += count;
+            size -= count;
+        }
+    }
+
+    const int fFile;
+    uint32_t fSize;
+    uint8_t fRunningStatus;
+    bool fError;
+    uint8_t fBuffer[kBufferSize];
+};
+
+// -----------------------------------------------------------------------
+
+/**
+  Runs a processor on a raw MIDI byte stream.
+
+  The messages parsed from each chunk of input are collected into blocks of
+  at most kMaxBlockEvents events, which are processed and written out before
+  process() returns, so the latency is bounded by the size of the chunks
+  read. All events of a block have frame 0, since a raw stream carries no
+  timing. The buffers are fixed, so there is no allocation per event.
+*/
+class MidiByteStreamProcessor {
+public:
+    static constexpr uint32_t kMaxBlockEvents = MidiEventBuffer::kCapacity / kMaxMidiFanOut;
+    static constexpr uint32_t kSysExPoolSize = 2 * MidiByteStreamParser::kMaxSysExSize;
+
+    MidiByteStreamProcessor(MidiProcessor& processor, int outFd) noexcept
+        : fProcessor(processor),
+          fWriter(outFd),
+          fCount(0),
+          fSysExUsed(0),
+          fEventsIn(0),
+          fEventsOut(0) {}
+
+    /**
+      Process the @a size bytes at @a data and write the output.
+      Returns false if writing failed.
+    */
+    bool process(const uint8_t* data, size_t size) {
+        fParser.parse(data, size, [this](const uint8_t* msg, uint32_t msgSize) {
+            add(msg, msgSize);
+        });
+
+        processBlock();
+        return fWriter.flush();
+    }
+
+    uint64_t getEventsIn() const noexcept {
+        return fEventsIn;
+    }
+
+    uint64_t getEventsOut() const noexcept {
+        return fEventsOut;
+    }
+
+    /**
+      Return the number of events lost, either SysEx messages too long for
+      the parser or events which didn't fit into the output buffer.
+    */
+    uint64_t getDroppedCount() const noexcept {
+        return fParser.getDroppedCount() + fOutput.getDroppedCount();
+    }
+
+private:
+    void add(const uint8_t* data, uint32_t size) {
+        if (fCount == kMaxBlockEvents || (size > MidiEvent::kDataSize && fSysExUsed + size > kSysExPoolSize))
+            processBlock();
+
+        MidiEvent& ev(fEvents[fCount++]);
+        ev.frame = 0;
+        ev.size = size;
+
+        if (size > MidiEvent::kDataSize) {
+            std::memcpy(fSysEx + fSysExUsed, data, size);
+            ev.dataExt = fSysEx + fSysExUsed;
+            fSysExUsed += size;
+        }
+        else {
+            std::memcpy(ev.data, data, size);
+        }
+
+        fEventsIn++;
+    }
+
+    void processBlock() {
+        if (fCount == 0)
+            return;
+
+        fOutput.clear();
+        fProcessor.process(fEvents, fCount, fOutput);
+
+        for (uint32_t i=0; i < fOutput.size(); i++)
+            fWriter.write(fOutput.data()[i]);
+
+        fEventsOut += fOutput.size();
+        fCount = 0;
+        fSysExUsed = 0;
+    }
+
+    MidiProcessor& fProcessor;
+    MidiByteStreamParser fParser;
+    MidiByteStreamWriter fWriter;
+    uint32_t fCount;
+    uint32_t fSysExUsed;
+    uint64_t fEventsIn;
+    uint64_t fEventsOut;
+    MidiEvent fEvents[kMaxBlockEvents];
+    uint8_t fSysEx[kSysExPoolSize];
+    MidiEventBuffer fOutput;
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_BYTE_STREAM_H
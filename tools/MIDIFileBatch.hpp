@@ -0,0 +1,189 @@
+/*
+ * Batch processing of MIDI files for midiomatic tools
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_FILE_BATCH_H
+#define MIDI_FILE_BATCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <strings.h>
+#include <sys/stat.h>
+
+#include "MIDIFileProcessing.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+struct MidiFileJob {
+    std::string inPath;
+    std::string outPath;
+    uint64_t size;
+};
+
+struct MidiFileBatchStats {
+    uint64_t files;
+    uint64_t filesFailed;
+    MidiFileProcessingStats events;
+    double seconds;
+
+    MidiFileBatchStats() noexcept
+        : files(0), filesFailed(0), seconds(0.0) {}
+};
+
+static inline bool isMidiFileName(const char* name) {
+    const char* ext = std::strrchr(name, '.');
+    return ext != nullptr && (strcasecmp(ext, ".mid") == 0 || strcasecmp(ext, ".midi") == 0);
+}
+
+/**
+  Add a job for each MIDI file (*.mid, *.midi) below directory @a inDir to
+  @a jobs, with the output path at the same place below @a outDir. The
+  directories of the output files are created here, so the workers never
+  need to. Returns false if a directory can't be read or created.
+*/
+static inline bool collectMidiFileJobs(const std::string& inDir, const std::string& outDir,
+                                       std::vector<MidiFileJob>& jobs) {
+    DIR* dir;
+    struct dirent* entry;
+    bool ok = true;
+
+    if (mkdir(outDir.c_str(), 0777) != 0 && errno != EEXIST) {
+        std::fprintf(stderr, "%s: could not create directory.\n", outDir.c_str());
+        return false;
+    }
+
+    if ((dir = opendir(inDir.c_str())) == nullptr) {
+        std::fprintf(stderr, "%s: could not read directory.\n", inDir.c_str());
+        return false;
+    }
+
+    while (ok && (entry = readdir(dir)) != nullptr) {
+        struct stat st;
+
+        if (entry->d_name[0] == '.')
+            continue;
+
+        const std::string inPath = inDir + "/" + entry->d_name;
+        const std::string outPath = outDir + "/" + entry->d_name;
+
+        if (stat(inPath.c_str(), &st) != 0)
+            continue;
+
+        if (S_ISDIR(st.st_mode)) {
+            ok = collectMidiFileJobs(inPath, outPath, jobs);
+        }
+        else if (S_ISREG(st.st_mode) && isMidiFileName(entry->d_name)) {
+            MidiFileJob job = {inPath, outPath, (uint64_t) st.st_size};
+            jobs.push_back(job);
+        }
+    }
+
+    closedir(dir);
+    return ok;
+}
+
+/**
+  Process all @a jobs with @a numThreads worker threads.
+
+  @a createProcessor is called once by each worker to make the worker's own
+  processor instance, so the workers share no processor state. It must
+  return nullptr on failure. processMidiFile() resets the processor for each
+  track, so no state is carried over from one file to the next and the
+  output of a file doesn't depend on the worker or the files processed
+  before. The counts are kept on each worker's stack and summed up when all
+  workers are done.
+
+  The workers take the next job from a shared atomic index whenever they are
+  done with a file, so a worker which got small files simply takes more of
+  them. The jobs are sorted by file size, largest first, so that no big file
+  is left for the end while the other workers are idle.
+*/
+template <class Factory>
+static bool processMidiFileBatch(std::vector<MidiFileJob>& jobs, Factory createProcessor,
+                                 const MidiFileProcessingOptions& options, uint32_t numThreads,
+                                 MidiFileBatchStats& stats) {
+    std::atomic<size_t> nextJob(0);
+    std::vector<MidiFileBatchStats> threadStats(std::max<uint32_t>(numThreads, 1));
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+
+    std::sort(jobs.begin(), jobs.end(), [](const MidiFileJob& a, const MidiFileJob& b) {
+        return a.size > b.size;
+    });
+
+    auto worker = [&](MidiFileBatchStats& result) {
+        MidiProcessor* processor = createProcessor();
+        MidiFileBatchStats local;
+        size_t index;
+
+        while ((index = nextJob.fetch_add(1, std::memory_order_relaxed)) < jobs.size()) {
+            const MidiFileJob& job = jobs[index];
+
+            if (processor != nullptr &&
+                processMidiFile(job.inPath.c_str(), job.outPath.c_str(), *processor, options, local.events))
+                local.files++;
+            else
+                local.filesFailed++;
+        }
+
+        delete processor;
+        result = local;
+    };
+
+    for (size_t i=1; i < threadStats.size(); i++)
+        threads.push_back(std::thread(worker, std::ref(threadStats[i])));
+
+    worker(threadStats[0]);
+
+    for (size_t i=0; i < threads.size(); i++)
+        threads[i].join();
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t i=0; i < threadStats.size(); i++) {
+        stats.files += threadStats[i].files;
+        stats.filesFailed += threadStats[i].filesFailed;
+        stats.events.eventsIn += threadStats[i].events.eventsIn;
+        stats.events.eventsOut += threadStats[i].events.eventsOut;
+        stats.events.eventsDropped += threadStats[i].events.eventsDropped;
+    }
+
+    return stats.filesFailed == 0;
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_FILE_BATCH_H
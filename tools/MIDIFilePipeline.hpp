@@ -0,0 +1,531 @@
+/*
+ * Pipelined processing of MIDI files for midiomatic tools
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_FILE_PIPELINE_H
+#define MIDI_FILE_PIPELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIFileProcessing.hpp"
+#include "MIDIUtils.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  A unit of work passed along the pipeline: a block of MIDI events, a meta
+  or escaped event, or a marker for the start and end of a track and of the
+  file.
+
+  The SysEx data of the events, or the payload of a meta event, is kept in
+  @a data, so a block never points into another one. The @a ticks of the
+  input events at @a tickFrames are passed on with each block created from
+  them, so the writer can give each output event the tick of the input event
+  at the same frame.
+*/
+struct MidiFileBlock {
+    enum Type {
+        kMidi,
+        kMeta,
+        kBeginTrack,
+        kEndTrack,
+        kEnd
+    };
+
+    static constexpr uint32_t kMaxInputEvents = MidiFileBlockProcessor::kMaxBlockEvents;
+
+    Type type;
+    uint8_t status;
+    uint8_t metaType;
+    uint64_t tick;
+    uint32_t count;
+    uint32_t tickCount;
+    MidiEvent events[MidiEventBuffer::kCapacity];
+    uint32_t tickFrames[kMaxInputEvents];
+    uint64_t ticks[kMaxInputEvents];
+    std::vector<uint8_t> data;
+
+    /**
+      Set the events of this block to a copy of @a source, with their SysEx
+      data copied to @a data.
+    */
+    void setEvents(const MidiEvent* source, uint32_t sourceCount) {
+        size_t size = 0;
+
+        type = kMidi;
+        count = sourceCount;
+        std::memcpy(events, source, sizeof(MidiEvent) * sourceCount);
+
+        for (uint32_t i=0; i < count; i++) {
+            if (events[i].size > MidiEvent::kDataSize)
+                size += events[i].size;
+        }
+
+        data.clear();
+
+        if (size == 0)
+            return;
+
+        // reserve first, so the pointers set below stay valid
+        data.reserve(size);
+
+        for (uint32_t i=0; i < count; i++) {
+            if (events[i].size > MidiEvent::kDataSize) {
+                data.insert(data.end(), events[i].dataExt, events[i].dataExt + events[i].size);
+                events[i].dataExt = data.data() + data.size() - events[i].size;
+            }
+        }
+    }
+
+    void setTicks(const MidiFileBlock& other) noexcept {
+        tickCount = other.tickCount;
+        std::memcpy(tickFrames, other.tickFrames, sizeof(uint32_t) * tickCount);
+        std::memcpy(ticks, other.ticks, sizeof(uint64_t) * tickCount);
+    }
+
+    /**
+      Return the tick for an output event at @a frame. @a index is the
+      position of the search and must be reset for each block.
+    */
+    uint64_t findTick(uint32_t frame, uint32_t& index) const noexcept {
+        while (index + 1 < tickCount && tickFrames[index] < frame)
+            index++;
+
+        return ticks[index];
+    }
+};
+
+/**
+  Bounded single-producer, single-consumer ring of blocks between two
+  pipeline threads.
+
+  The producer fills the slot returned by beginWrite() in place and passes
+  it on with endWrite(), the consumer works on the slot returned by
+  beginRead() and gives it back with endRead(), so the blocks are never
+  copied in and out of the ring. When the ring is full or empty, the waiting
+  side yields the CPU and tries again, so a fast stage is throttled to the
+  speed of the slowest one.
+*/
+class MidiFileBlockRing {
+public:
+    static constexpr uint32_t kSize = 16;
+
+    MidiFileBlockRing() noexcept
+        : fHead(0),
+          fTail(0) {}
+
+    MidiFileBlock& beginWrite() noexcept {
+        const uint32_t tail = fTail.load(std::memory_order_relaxed);
+
+        while (tail - fHead.load(std::memory_order_acquire) >= kSize)
+            std::this_thread::yield();
+
+        return fSlots[tail % kSize];
+    }
+
+    void endWrite() noexcept {
+        fTail.store(fTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    MidiFileBlock& beginRead() noexcept {
+        const uint32_t head = fHead.load(std::memory_order_relaxed);
+
+        while (head == fTail.load(std::memory_order_acquire))
+            std::this_thread::yield();
+
+        return fSlots[head % kSize];
+    }
+
+    void endRead() noexcept {
+        fHead.store(fHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    std::atomic<uint32_t> fHead;
+    // consumer and producer index on separate cache lines
+    char fPadding[CACHE_LINE_SIZE];
+    std::atomic<uint32_t> fTail;
+    char fPadding2[CACHE_LINE_SIZE];
+    MidiFileBlock fSlots[kSize];
+};
+
+// -----------------------------------------------------------------------
+
+struct MidiFilePipelineStats {
+    MidiFileProcessingStats events;
+    // wall clock time of the whole run
+    double seconds;
+    // time each thread spent working, not waiting: reader, stages, writer
+    std::vector<double> busySeconds;
+
+    MidiFilePipelineStats() noexcept
+        : seconds(0.0) {}
+};
+
+/**
+  Measures the time a pipeline thread spends working.
+*/
+class MidiFileBusyTimer {
+public:
+    MidiFileBusyTimer() noexcept
+        : fSeconds(0.0) {}
+
+    void start() noexcept {
+        fStart = std::chrono::steady_clock::now();
+    }
+
+    void stop() noexcept {
+        fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - fStart).count();
+    }
+
+    double getSeconds() const noexcept {
+        return fSeconds;
+    }
+
+private:
+    std::chrono::steady_clock::time_point fStart;
+    double fSeconds;
+};
+
+/**
+  Reads the tracks of a file and passes them on as blocks, assembled the
+  same way as by MidiFileBlockProcessor, except that a meta or escaped event
+  ends the current block and is passed on in a block of its own.
+*/
+static inline bool readMidiFileBlocks(MidiFileReader& reader, const char* inPath, const MidiFileProcessingOptions& options,
+                                      MidiFileBlockRing& out, uint64_t& eventsIn, MidiFileBusyTimer& busy) {
+    const uint32_t blockSize = options.blockSize > 0 ? options.blockSize : 1;
+    MidiFileTrackReader track;
+    MidiFileEvent event;
+    MidiFileBlock* block = nullptr;
+    uint32_t sysExOffsets[MidiFileBlock::kMaxInputEvents];
+    uint64_t blockStart = 0;
+    uint16_t trackIndex = 0;
+    bool ok = true;
+
+    auto flush = [&]() {
+        if (block == nullptr)
+            return;
+
+        for (uint32_t i=0; i < block->count; i++) {
+            if (block->events[i].size > MidiEvent::kDataSize)
+                block->events[i].dataExt = block->data.data() + sysExOffsets[i];
+        }
+
+        busy.stop();
+        out.endWrite();
+        busy.start();
+        block = nullptr;
+    };
+
+    auto begin = [&](MidiFileBlock::Type type) -> MidiFileBlock& {
+        busy.stop();
+        MidiFileBlock& next(out.beginWrite());
+        busy.start();
+        next.type = type;
+        next.count = 0;
+        next.tickCount = 0;
+        next.data.clear();
+        return next;
+    };
+
+    busy.start();
+
+    for (; ok && reader.nextTrack(track); trackIndex++) {
+        MidiFileTimeConverter time;
+
+        if (!time.begin(reader, trackIndex, options.sampleRate)) {
+            std::fprintf(stderr, "%s: could not read the tempo track.\n", inPath);
+            ok = false;
+            break;
+        }
+
+        begin(MidiFileBlock::kBeginTrack);
+        out.endWrite();
+
+        while (track.next(event)) {
+            if (!event.isMidi()) {
+                // keep meta and escaped events in order with the processed ones
+                flush();
+                MidiFileBlock& meta(begin(MidiFileBlock::kMeta));
+                meta.status = event.status;
+                meta.metaType = event.metaType;
+                meta.tick = event.tick;
+                meta.data.assign(event.data, event.data + event.size);
+                out.endWrite();
+                continue;
+            }
+
+            const uint64_t frame = time.toFrame(event.tick);
+
+            if (block != nullptr && (frame >= blockStart + blockSize || block->count >= MidiFileBlock::kMaxInputEvents))
+                flush();
+
+            if (block == nullptr) {
+                block = &begin(MidiFileBlock::kMidi);
+                blockStart = frame - frame % blockSize;
+            }
+
+            MidiEvent& ev(block->events[block->count]);
+            ev.frame = (uint32_t) (frame - blockStart);
+            ev.size = event.size;
+
+            if (event.size > MidiEvent::kDataSize) {
+                sysExOffsets[block->count] = (uint32_t) block->data.size();
+                block->data.insert(block->data.end(), event.data, event.data + event.size);
+            }
+            else {
+                std::memcpy(ev.data, event.data, event.size);
+            }
+
+            block->tickFrames[block->count] = ev.frame;
+            block->ticks[block->count] = event.tick;
+            block->count++;
+            block->tickCount++;
+            eventsIn++;
+        }
+
+        flush();
+        begin(MidiFileBlock::kEndTrack);
+        out.endWrite();
+
+        if (!track.isComplete())
+            std::fprintf(stderr, "%s: warning: invalid data in track %u skipped.\n", inPath, trackIndex + 1);
+    }
+
+    if (ok && trackIndex < reader.getTrackCount())
+        std::fprintf(stderr, "%s: warning: only %u of %u tracks found.\n", inPath,
+                     trackIndex, reader.getTrackCount());
+
+    begin(MidiFileBlock::kEnd);
+    out.endWrite();
+    busy.stop();
+    return ok;
+}
+
+/**
+  Runs @a processor on the blocks from @a in and passes the results on to
+  @a out. Other blocks are passed on unchanged.
+
+  A stage splits its input into chunks of at most kMaxInputEvents events, so
+  the output of each chunk fits into a MidiEventBuffer, however many events
+  the stages before it generated. The processor is reset at the start of
+  each track.
+*/
+static inline void runMidiFileStage(MidiProcessor& processor, MidiFileBlockRing& in, MidiFileBlockRing& out,
+                                    uint64_t& eventsDropped, MidiFileBusyTimer& busy) {
+    MidiEventBuffer* output = new MidiEventBuffer();
+    bool done = false;
+
+    while (!done) {
+        MidiFileBlock& block(in.beginRead());
+
+        busy.start();
+
+        if (block.type == MidiFileBlock::kMidi) {
+            for (uint32_t start=0; start < block.count; start += MidiFileBlock::kMaxInputEvents) {
+                // not std::min(), which takes a reference and needs a definition of kMaxInputEvents
+                const uint32_t count = block.count - start < MidiFileBlock::kMaxInputEvents
+                    ? block.count - start : MidiFileBlock::kMaxInputEvents;
+
+                output->clear();
+                processor.process(block.events + start, count, *output);
+
+                if (output->size() == 0)
+                    continue;
+
+                busy.stop();
+                MidiFileBlock& next(out.beginWrite());
+                busy.start();
+                next.setEvents(output->data(), output->size());
+                next.setTicks(block);
+                out.endWrite();
+            }
+        }
+        else {
+            if (block.type == MidiFileBlock::kBeginTrack)
+                processor.reset();
+
+            busy.stop();
+            MidiFileBlock& next(out.beginWrite());
+            busy.start();
+            next.type = block.type;
+            next.status = block.status;
+            next.metaType = block.metaType;
+            next.tick = block.tick;
+            next.data = block.data;
+            out.endWrite();
+            done = block.type == MidiFileBlock::kEnd;
+        }
+
+        busy.stop();
+        in.endRead();
+    }
+
+    eventsDropped += output->getDroppedCount();
+    delete output;
+}
+
+/**
+  Write the blocks from @a in to @a writer, until the end of the file.
+*/
+static inline void writeMidiFileBlocks(MidiFileBlockRing& in, MidiFileWriter& writer,
+                                       uint64_t& eventsOut, MidiFileBusyTimer& busy) {
+    for (;;) {
+        MidiFileBlock& block(in.beginRead());
+        uint32_t index = 0;
+
+        busy.start();
+
+        switch (block.type) {
+            case MidiFileBlock::kMidi:
+                for (uint32_t i=0; i < block.count; i++)
+                    writer.writeEvent(block.findTick(block.events[i].frame, index), block.events[i]);
+
+                eventsOut += block.count;
+                break;
+            case MidiFileBlock::kMeta:
+                if (block.status == 0xFF)
+                    writer.writeMeta(block.tick, block.metaType, block.data.data(), block.data.size());
+                else
+                    writer.writeEscaped(block.tick, block.data.data(), block.data.size());
+                break;
+            case MidiFileBlock::kBeginTrack:
+                writer.beginTrack();
+                break;
+            case MidiFileBlock::kEndTrack:
+                writer.endTrack();
+                break;
+            case MidiFileBlock::kEnd:
+                busy.stop();
+                in.endRead();
+                return;
+        }
+
+        busy.stop();
+        in.endRead();
+    }
+}
+
+/**
+  Stream all tracks of the Standard MIDI File at @a inPath through the chain
+  of processors @a stages and write the result to @a outPath.
+
+  Reading, each stage and writing run on their own thread, connected by
+  MidiFileBlockRings, so the throughput is that of the slowest of them. The
+  result is the same as running the processors one after another with
+  processMidiFile(). Returns false and prints an error message if reading or
+  writing fails.
+*/
+static inline bool processMidiFilePipeline(const char* inPath, const char* outPath,
+                                           const std::vector<MidiProcessor*>& stages,
+                                           const MidiFileProcessingOptions& options,
+                                           MidiFilePipelineStats& stats) {
+    const size_t numStages = stages.size();
+    MidiFileReader reader;
+    MidiFileWriter writer;
+    std::vector<MidiFileBlockRing*> rings;
+    std::vector<double> busy(numStages + 2, 0.0);
+    std::vector<uint64_t> dropped(numStages, 0);
+    std::vector<std::thread> threads;
+    uint64_t eventsIn = 0;
+    bool readOk = true;
+
+    if (!reader.open(inPath)) {
+        std::fprintf(stderr, "%s: not a readable Standard MIDI File.\n", inPath);
+        return false;
+    }
+
+    if (!writer.open(outPath, reader.getFormat(), reader.getTrackCount(), reader.getDivision())) {
+        std::fprintf(stderr, "%s: could not create file.\n", outPath);
+        return false;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (size_t i=0; i <= numStages; i++)
+        rings.push_back(new MidiFileBlockRing());
+
+    // each thread counts on its own stack and stores the results when done
+    threads.push_back(std::thread([&]() {
+        MidiFileBusyTimer timer;
+        uint64_t count = 0;
+        readOk = readMidiFileBlocks(reader, inPath, options, *rings[0], count, timer);
+        eventsIn = count;
+        busy[0] = timer.getSeconds();
+    }));
+
+    for (size_t i=0; i < numStages; i++) {
+        threads.push_back(std::thread([&, i]() {
+            MidiFileBusyTimer timer;
+            uint64_t count = 0;
+            runMidiFileStage(*stages[i], *rings[i], *rings[i + 1], count, timer);
+            dropped[i] = count;
+            busy[i + 1] = timer.getSeconds();
+        }));
+    }
+
+    MidiFileBusyTimer timer;
+    writeMidiFileBlocks(*rings[numStages], writer, stats.events.eventsOut, timer);
+    busy[numStages + 1] = timer.getSeconds();
+
+    for (size_t i=0; i < threads.size(); i++)
+        threads[i].join();
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.busySeconds = busy;
+    stats.events.eventsIn += eventsIn;
+
+    for (size_t i=0; i < numStages; i++) {
+        stats.events.eventsDropped += dropped[i];
+        delete rings[i];
+    }
+
+    delete rings[numStages];
+
+    if (!readOk)
+        return false;
+
+    if (!writer.close()) {
+        std::fprintf(stderr, "%s: error writing file.\n", outPath);
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_FILE_PIPELINE_H
@@ -0,0 +1,300 @@
+/*
+ * Offline Standard MIDI File processing for midiomatic tools
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_FILE_PROCESSING_H
+#define MIDI_FILE_PROCESSING_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIFileReader.hpp"
+#include "MIDIFileWriter.hpp"
+#include "MIDIProcessor.hpp"
+#include "MIDIToolProcessors.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+struct MidiFileProcessingOptions {
+    double sampleRate;
+    uint32_t blockSize;
+    // also call process() for the blocks without events, like a plugin host
+    bool emptyBlocks;
+
+    MidiFileProcessingOptions() noexcept
+        : sampleRate(48000.0), blockSize(256), emptyBlocks(false) {}
+};
+
+struct MidiFileProcessingStats {
+    uint64_t eventsIn;
+    uint64_t eventsOut;
+    uint64_t eventsDropped;
+    // process() calls, the frames of the track timelines and the time spent in process()
+    uint64_t blocks;
+    uint64_t frames;
+    double processSeconds;
+
+    MidiFileProcessingStats() noexcept
+        : eventsIn(0), eventsOut(0), eventsDropped(0), blocks(0), frames(0), processSeconds(0.0) {}
+};
+
+/**
+  Feeds the MIDI events of a track to a processor in blocks of sample frames,
+  like a plugin host would, and writes the output to a MidiFileWriter.
+
+  The blocks are aligned to multiples of the block size on the track's
+  timeline. Meta and escaped events don't end a block, they are held back
+  and written between the output events, so the blocks don't depend on where
+  the track happens to have them. Output events get the tick of the input
+  event at the same frame, so ticks are not affected by rounding to frames.
+  The time spent in the processor's process() is added to the stats.
+*/
+class MidiFileBlockProcessor {
+public:
+    /**
+      At most this many input events are processed in one block, so the
+      output always fits into the MidiEventBuffer.
+    */
+    static constexpr uint32_t kMaxBlockEvents = MidiEventBuffer::kCapacity / kMaxMidiFanOut;
+
+    MidiFileBlockProcessor(MidiProcessor& processor, MidiFileWriter& writer,
+                           MidiFileProcessingStats& stats, uint32_t blockSize, bool emptyBlocks = false)
+        : fProcessor(processor),
+          fWriter(writer),
+          fStats(stats),
+          fBlockSize(blockSize > 0 ? blockSize : 1),
+          fEmptyBlocks(emptyBlocks),
+          fBlockStart(0),
+          fNextBlock(0),
+          fCount(0) {}
+
+    ~MidiFileBlockProcessor() {
+        fStats.frames += fNextBlock;
+    }
+
+    /**
+      Add the MIDI event @a event at sample frame @a frame, processing the
+      current block first if the event doesn't belong to it.
+    */
+    void add(const MidiFileEvent& event, uint64_t frame) {
+        if (fCount > 0 && (frame >= fBlockStart + fBlockSize || fCount >= kMaxBlockEvents))
+            flush();
+
+        if (fCount == 0) {
+            fBlockStart = frame - frame % fBlockSize;
+
+            while (fEmptyBlocks && fNextBlock < fBlockStart) {
+                fOutput.clear();
+                process(0);
+                fNextBlock += fBlockSize;
+            }
+        }
+
+        MidiEvent& ev(fEvents[fCount]);
+        ev.frame = (uint32_t) (frame - fBlockStart);
+        ev.size = event.size;
+
+        if (event.size > MidiEvent::kDataSize) {
+            fSysExOffsets[fCount] = (uint32_t) fSysEx.size();
+            fSysEx.insert(fSysEx.end(), event.data, event.data + event.size);
+        }
+        else {
+            std::memcpy(ev.data, event.data, event.size);
+        }
+
+        fTicks[fCount++] = event.tick;
+        fStats.eventsIn++;
+    }
+
+    /**
+      Add the meta or escaped event @a event. It is written after the output
+      of the MIDI events added before it and before the output of the ones
+      added after it. Its data must stay valid until the next flush().
+    */
+    void addOther(const MidiFileEvent& event) {
+        if (fCount == 0) {
+            writeOther(event);
+            return;
+        }
+
+        fOther.push_back(event);
+        fOtherPositions.push_back(fCount);
+    }
+
+    /**
+      Process the events of the current block and write the output.
+    */
+    void flush() {
+        uint32_t j = 0;
+        size_t k = 0;
+
+        if (fCount == 0)
+            return;
+
+        // the SysEx buffer may have moved while it was filled
+        for (uint32_t i=0; i < fCount; i++) {
+            if (fEvents[i].size > MidiEvent::kDataSize)
+                fEvents[i].dataExt = fSysEx.data() + fSysExOffsets[i];
+        }
+
+        fOutput.clear();
+        process(fCount);
+
+        for (uint32_t i=0; i < fOutput.size(); i++) {
+            const MidiEvent& ev(fOutput.data()[i]);
+
+            while (j + 1 < fCount && fEvents[j].frame < ev.frame)
+                j++;
+
+            for (; k < fOther.size() && fOtherPositions[k] <= j; k++)
+                writeOther(fOther[k]);
+
+            fWriter.writeEvent(fTicks[j], ev);
+        }
+
+        for (; k < fOther.size(); k++)
+            writeOther(fOther[k]);
+
+        fOther.clear();
+        fOtherPositions.clear();
+
+        fStats.eventsOut += fOutput.size();
+        fStats.eventsDropped += fOutput.getDroppedCount();
+        fSysEx.clear();
+        fCount = 0;
+        fNextBlock = fBlockStart + fBlockSize;
+    }
+
+private:
+    void writeOther(const MidiFileEvent& event) {
+        if (event.isMeta())
+            fWriter.writeMeta(event.tick, event.metaType, event.data, event.size);
+        else
+            fWriter.writeEscaped(event.tick, event.data, event.size);
+    }
+
+    void process(uint32_t count) {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        fProcessor.process(fEvents, count, fOutput);
+        fStats.processSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fStats.blocks++;
+    }
+
+    MidiProcessor& fProcessor;
+    MidiFileWriter& fWriter;
+    MidiFileProcessingStats& fStats;
+    const uint32_t fBlockSize;
+    const bool fEmptyBlocks;
+    uint64_t fBlockStart;
+    uint64_t fNextBlock;
+    uint32_t fCount;
+    MidiEvent fEvents[kMaxBlockEvents];
+    uint64_t fTicks[kMaxBlockEvents];
+    uint32_t fSysExOffsets[kMaxBlockEvents];
+    std::vector<uint8_t> fSysEx;
+    std::vector<MidiFileEvent> fOther;
+    std::vector<uint32_t> fOtherPositions;
+    MidiEventBuffer fOutput;
+};
+
+/**
+  Stream all tracks of the Standard MIDI File at @a inPath through
+  @a processor and write the result to @a outPath.
+
+  The input file is mapped into memory, the events are processed one block
+  at a time. Meta events and escaped events are copied unchanged. The
+  processor is reset at the start of each track. Returns false and prints an
+  error message if reading or writing fails.
+*/
+static inline bool processMidiFile(const char* inPath, const char* outPath, MidiProcessor& processor,
+                                   const MidiFileProcessingOptions& options, MidiFileProcessingStats& stats) {
+    MidiFileReader reader;
+    MidiFileWriter writer;
+    MidiFileTrackReader track;
+    MidiFileEvent event;
+    uint16_t trackIndex = 0;
+
+    if (!reader.open(inPath)) {
+        std::fprintf(stderr, "%s: not a readable Standard MIDI File.\n", inPath);
+        return false;
+    }
+
+    if (!writer.open(outPath, reader.getFormat(), reader.getTrackCount(), reader.getDivision())) {
+        std::fprintf(stderr, "%s: could not create file.\n", outPath);
+        return false;
+    }
+
+    for (; reader.nextTrack(track); trackIndex++) {
+        MidiFileTimeConverter time;
+        MidiFileBlockProcessor* blocks = new MidiFileBlockProcessor(processor, writer, stats, options.blockSize,
+                                                                   options.emptyBlocks);
+        bool ok = time.begin(reader, trackIndex, options.sampleRate);
+
+        processor.reset();
+        writer.beginTrack();
+
+        while (ok && track.next(event)) {
+            if (event.isMidi())
+                blocks->add(event, time.toFrame(event.tick));
+            else
+                blocks->addOther(event);
+        }
+
+        blocks->flush();
+        writer.endTrack();
+        delete blocks;
+
+        if (!ok) {
+            std::fprintf(stderr, "%s: could not read the tempo track.\n", inPath);
+            return false;
+        }
+
+        if (!track.isComplete())
+            std::fprintf(stderr, "%s: warning: invalid data in track %u skipped.\n", inPath, trackIndex + 1);
+    }
+
+    if (trackIndex < reader.getTrackCount())
+        std::fprintf(stderr, "%s: warning: only %u of %u tracks found.\n", inPath,
+                     trackIndex, reader.getTrackCount());
+
+    if (!writer.close()) {
+        std::fprintf(stderr, "%s: error writing file.\n", outPath);
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_FILE_PROCESSING_H
@@ -0,0 +1,441 @@
+/*
+ * Streaming Standard MIDI File reader for midiomatic tools
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_FILE_READER_H
+#define MIDI_FILE_READER_H
+
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "DistrhoPlugin.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  One event of a track of a Standard MIDI File.
+
+  For channel messages @a data holds the complete message, including the
+  status byte, also if the file used running status. For SysEx events (status
+  0xF0) it holds the message including the leading 0xF0, for escaped events
+  (0xF7) and meta events (0xFF) only the payload. @a data is only valid until
+  the next call of MidiFileTrackReader::next().
+*/
+struct MidiFileEvent {
+    uint64_t tick;
+    uint8_t status;
+    uint8_t metaType;
+    uint32_t size;
+    const uint8_t* data;
+
+    bool isMeta() const noexcept {
+        return status == 0xFF;
+    }
+
+    bool isMidi() const noexcept {
+        return status != 0xFF && status != 0xF7;
+    }
+};
+
+/**
+  Reads the events of one track chunk sequentially from the mapped file.
+  Only SysEx messages are copied, to put the 0xF0 in front of them.
+*/
+class MidiFileTrackReader {
+public:
+    static constexpr uint8_t kMetaTempo = 0x51;
+    static constexpr uint8_t kMetaEndOfTrack = 0x2F;
+
+    MidiFileTrackReader() noexcept
+        : fPos(nullptr), fEnd(nullptr), fTick(0), fRunningStatus(0) {}
+
+    /**
+      Start reading the track data from @a data to @a end.
+    */
+    void begin(const uint8_t* data, const uint8_t* end) noexcept {
+        fPos = data;
+        fEnd = end;
+        fTick = 0;
+        fRunningStatus = 0;
+    }
+
+    /**
+      Return whether all data of the track has been read. If next() returned
+      false before that, the track data is invalid.
+    */
+    bool isComplete() const noexcept {
+        return fPos == fEnd;
+    }
+
+    /**
+      Read the next event into @a event.
+      Returns false at the end of the track or if the track data is invalid.
+    */
+    bool next(MidiFileEvent& event) {
+        uint32_t delta, length;
+        uint8_t status;
+
+        if (fPos == fEnd || !readVarLen(delta) || fPos == fEnd)
+            return false;
+
+        status = *fPos++;
+        fTick += delta;
+        event.tick = fTick;
+        event.metaType = 0;
+
+        if (status == 0xFF) {
+            if (fPos == fEnd)
+                return false;
+
+            event.metaType = *fPos++;
+
+            if (!readVarLen(length) || length > (uint32_t) (fEnd - fPos))
+                return false;
+
+            event.data = fPos;
+            fPos += length;
+        }
+        else if (status == 0xF0 || status == 0xF7) {
+            // SysEx and escape events cancel running status
+            fRunningStatus = 0;
+
+            if (!readVarLen(length) || length > (uint32_t) (fEnd - fPos))
+                return false;
+
+            if (status == 0xF0) {
+                fSysEx.resize(length + 1);
+                fSysEx[0] = 0xF0;
+                std::memcpy(fSysEx.data() + 1, fPos, length);
+                event.data = fSysEx.data();
+                fPos += length++;
+            }
+            else {
+                event.data = fPos;
+                fPos += length;
+            }
+        }
+        else {
+            if (status < 0x80) {
+                // running status, the byte read is the first data byte
+                if (fRunningStatus == 0)
+                    return false;
+
+                --fPos;
+                status = fRunningStatus;
+            }
+            else if (status >= 0xF0) {
+                // System Common / Real-Time messages are not valid in files
+                return false;
+            }
+            else {
+                fRunningStatus = status;
+            }
+
+            length = (status & 0xF0) == 0xC0 || (status & 0xF0) == 0xD0 ? 2 : 3;
+
+            if (length - 1 > (uint32_t) (fEnd - fPos))
+                return false;
+
+            fMessage[0] = status;
+
+            for (uint32_t i=1; i < length; i++)
+                fMessage[i] = *fPos++ & 0x7F;
+
+            event.data = fMessage;
+        }
+
+        event.status = status;
+        event.size = length;
+        return true;
+    }
+
+private:
+    bool readVarLen(uint32_t& value) noexcept {
+        value = 0;
+
+        for (int i=0; i < 4 && fPos != fEnd; i++) {
+            const uint8_t byte = *fPos++;
+
+            value = (value << 7) | (byte & 0x7F);
+
+            if (!(byte & 0x80))
+                return true;
+        }
+
+        return false;
+    }
+
+    const uint8_t* fPos;
+    const uint8_t* fEnd;
+    uint64_t fTick;
+    uint8_t fRunningStatus;
+    uint8_t fMessage[3];
+    std::vector<uint8_t> fSysEx;
+};
+
+// -----------------------------------------------------------------------
+
+/**
+  Maps a Standard MIDI File into memory and gives access to its tracks.
+
+  The file is read through mmap(), so the tracks are paged in by the kernel
+  as they are read and are never copied as a whole.
+*/
+class MidiFileReader {
+public:
+    MidiFileReader() noexcept
+        : fData(nullptr), fSize(0), fFormat(0), fTrackCount(0), fDivision(0), fNextChunk(0) {}
+
+    ~MidiFileReader() {
+        close();
+    }
+
+    /**
+      Open the file at @a path and read its header.
+      Returns false if the file can't be opened or is no Standard MIDI File.
+    */
+    bool open(const char* path) {
+        struct stat st;
+        uint32_t length;
+        int fd;
+
+        close();
+
+        if ((fd = ::open(path, O_RDONLY)) < 0)
+            return false;
+
+        if (fstat(fd, &st) != 0 || st.st_size < 14) {
+            ::close(fd);
+            return false;
+        }
+
+        void* data = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+            return false;
+
+        fData = (const uint8_t*) data;
+        fSize = (size_t) st.st_size;
+        madvise(data, fSize, MADV_SEQUENTIAL);
+
+        length = readUInt32(fData + 4);
+        fFormat = readUInt16(fData + 8);
+        fTrackCount = readUInt16(fData + 10);
+        fDivision = readUInt16(fData + 12);
+        fNextChunk = 8 + (size_t) length;
+
+        if (std::memcmp(fData, "MThd", 4) != 0 || length < 6 || fNextChunk > fSize ||
+            fFormat > 2 || fDivision == 0)
+        {
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void close() {
+        if (fData != nullptr) {
+            munmap((void*) fData, fSize);
+            fData = nullptr;
+        }
+    }
+
+    uint16_t getFormat() const noexcept {
+        return fFormat;
+    }
+
+    uint16_t getTrackCount() const noexcept {
+        return fTrackCount;
+    }
+
+    uint16_t getDivision() const noexcept {
+        return fDivision;
+    }
+
+    /**
+      Set up @a track to read the next track. Chunks of unknown type are
+      skipped. Returns false if there are no more tracks.
+    */
+    bool nextTrack(MidiFileTrackReader& track) noexcept {
+        return findTrack(fNextChunk, track);
+    }
+
+    /**
+      Set up @a track to read the track with index @a index, independently
+      of nextTrack(). Returns false if there is no such track.
+    */
+    bool getTrack(uint16_t index, MidiFileTrackReader& track) const noexcept {
+        size_t chunk = 8 + (size_t) readUInt32(fData + 4);
+
+        for (uint16_t i=0; i <= index; i++) {
+            if (!findTrack(chunk, track))
+                return false;
+        }
+
+        return true;
+    }
+
+private:
+    bool findTrack(size_t& chunk, MidiFileTrackReader& track) const noexcept {
+        while (fData != nullptr && fSize - chunk >= 8) {
+            const uint8_t* header = fData + chunk;
+            const size_t length = readUInt32(header + 4);
+
+            if (length > fSize - chunk - 8)
+                return false;
+
+            chunk += 8 + length;
+
+            if (std::memcmp(header, "MTrk", 4) == 0) {
+                track.begin(header + 8, header + 8 + length);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    static uint16_t readUInt16(const uint8_t* p) noexcept {
+        return (uint16_t) ((p[0] << 8) | p[1]);
+    }
+
+    static uint32_t readUInt32(const uint8_t* p) noexcept {
+        return ((uint32_t) p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    }
+
+    const uint8_t* fData;
+    size_t fSize;
+    uint16_t fFormat;
+    uint16_t fTrackCount;
+    uint16_t fDivision;
+    size_t fNextChunk;
+};
+
+// -----------------------------------------------------------------------
+
+/**
+  Converts the ticks of one track to sample frames at a given sample rate.
+
+  The tempo changes are read from the tempo track, i.e. the first track of
+  a format 0 or 1 file or the track itself in a format 2 file, with a second
+  track reader running alongside the track being converted. Thus the tempo
+  map never has to be collected. Ticks must be passed in ascending order.
+*/
+class MidiFileTimeConverter {
+public:
+    MidiFileTimeConverter() noexcept
+        : fSampleRate(48000.0), fTicksPerQuarter(0), fFramesPerTick(0.0),
+          fBaseTick(0), fBaseFrame(0.0), fHavePending(false) {}
+
+    /**
+      Start converting the ticks of track @a trackIndex of the file opened
+      with @a reader at @a sampleRate.
+      Returns false if the tempo track can't be found.
+    */
+    bool begin(const MidiFileReader& reader, uint16_t trackIndex, double sampleRate) {
+        const uint16_t division = reader.getDivision();
+        const uint16_t tempoTrack = reader.getFormat() == 2 ? trackIndex : 0;
+
+        fSampleRate = sampleRate;
+        fBaseTick = 0;
+        fBaseFrame = 0.0;
+        fHavePending = false;
+
+        if (division & 0x8000) {
+            // SMPTE time code: a fixed number of ticks per second
+            const int fps = -(int8_t) (division >> 8);
+            const double framesPerSecond = fps == 29 ? 29.97 : fps;
+            fTicksPerQuarter = 0;
+            fFramesPerTick = sampleRate / (framesPerSecond * (division & 0xFF));
+            return true;
+        }
+
+        fTicksPerQuarter = division;
+        setTempo(500000);
+
+        if (!reader.getTrack(tempoTrack, fTempoTrack))
+            return false;
+
+        readNextTempo();
+        return true;
+    }
+
+    /**
+      Return the sample frame at @a tick.
+    */
+    uint64_t toFrame(uint64_t tick) {
+        while (fHavePending && fPending.tick <= tick) {
+            fBaseFrame += (fPending.tick - fBaseTick) * fFramesPerTick;
+            fBaseTick = fPending.tick;
+            setTempo(fPendingTempo);
+            readNextTempo();
+        }
+
+        return (uint64_t) (fBaseFrame + (tick - fBaseTick) * fFramesPerTick + 0.5);
+    }
+
+private:
+    void setTempo(uint32_t microsPerQuarter) {
+        fFramesPerTick = fSampleRate * microsPerQuarter / (1000000.0 * fTicksPerQuarter);
+    }
+
+    void readNextTempo() {
+        fHavePending = false;
+
+        while (fTempoTrack.next(fPending)) {
+            if (fPending.isMeta() && fPending.metaType == MidiFileTrackReader::kMetaTempo && fPending.size == 3) {
+                fPendingTempo = ((uint32_t) fPending.data[0] << 16) | (fPending.data[1] << 8) | fPending.data[2];
+                fHavePending = fPendingTempo > 0;
+
+                if (fHavePending)
+                    return;
+            }
+        }
+    }
+
+    MidiFileTrackReader fTempoTrack;
+    MidiFileEvent fPending;
+    uint32_t fPendingTempo;
+    double fSampleRate;
+    uint16_t fTicksPerQuarter;
+    double fFramesPerTick;
+    uint64_t fBaseTick;
+    double fBaseFrame;
+    bool fHavePending;
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_FILE_READER_H
@@ -0,0 +1,288 @@
+/*
+ * Streaming Standard MIDI File writer for midiomatic tools
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_FILE_WRITER_H
+#define MIDI_FILE_WRITER_H
+
+#include <cstdio>
+
+#include "DistrhoPlugin.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Writes a Standard MIDI File one event at a time.
+
+  The length of each track chunk is filled in when the track is finished, so
+  the output must be a regular, seekable file. Running status is not used.
+
+  Whatever the processors output, the file stays readable: data bytes are
+  masked to 7 bits, messages get the length of their status byte and
+  variable-length quantities are limited to 28 bits.
+*/
+class MidiFileWriter {
+public:
+    static constexpr uint32_t kMaxVarLen = 0x0FFFFFFF;
+
+    MidiFileWriter() noexcept
+        : fFile(nullptr), fTrackStart(0), fTrackLength(0), fLastTick(0), fEndOfTrack(false) {}
+
+    ~MidiFileWriter() {
+        close();
+    }
+
+    /**
+      Create the file at @a path and write the header.
+      Returns false if the file can't be created.
+    */
+    bool open(const char* path, uint16_t format, uint16_t trackCount, uint16_t division) {
+        const uint8_t header[] = {
+            'M', 'T', 'h', 'd', 0, 0, 0, 6,
+            (uint8_t) (format >> 8), (uint8_t) format,
+            (uint8_t) (trackCount >> 8), (uint8_t) trackCount,
+            (uint8_t) (division >> 8), (uint8_t) division
+        };
+
+        close();
+
+        if ((fFile = std::fopen(path, "wb")) == nullptr)
+            return false;
+
+        return std::fwrite(header, 1, sizeof(header), fFile) == sizeof(header);
+    }
+
+    /**
+      Close the file. Returns false if writing any part of it failed.
+    */
+    bool close() {
+        bool ok = true;
+
+        if (fFile != nullptr) {
+            ok = !std::ferror(fFile);
+            ok = std::fclose(fFile) == 0 && ok;
+            fFile = nullptr;
+        }
+
+        return ok;
+    }
+
+    void beginTrack() {
+        const uint8_t header[] = {'M', 'T', 'r', 'k', 0, 0, 0, 0};
+
+        std::fwrite(header, 1, sizeof(header), fFile);
+        fTrackStart = std::ftell(fFile);
+        fTrackLength = 0;
+        fLastTick = 0;
+        fEndOfTrack = false;
+    }
+
+    /**
+      Add an End of Track event, unless the track already has one, and fill
+      in the length of the track chunk.
+    */
+    void endTrack() {
+        if (!fEndOfTrack)
+            writeMeta(fLastTick, 0x2F, nullptr, 0);
+
+        const long end = std::ftell(fFile);
+        const uint8_t length[] = {
+            (uint8_t) (fTrackLength >> 24), (uint8_t) (fTrackLength >> 16),
+            (uint8_t) (fTrackLength >> 8), (uint8_t) fTrackLength
+        };
+
+        std::fseek(fFile, fTrackStart - 4, SEEK_SET);
+        std::fwrite(length, 1, sizeof(length), fFile);
+        std::fseek(fFile, end, SEEK_SET);
+    }
+
+    /**
+      Write the MIDI message @a event at @a tick. SysEx messages (with
+      external data) are written as SysEx events, System Common and
+      Real-Time messages as escaped events. Events, which don't start with a
+      status byte or are shorter than their status requires, are skipped.
+    */
+    void writeEvent(uint64_t tick, const MidiEvent& event) {
+        const uint8_t* data = event.size > MidiEvent::kDataSize ? event.dataExt : event.data;
+
+        if (event.size == 0 || event.size > kMaxVarLen || fEndOfTrack)
+            return;
+
+        const uint8_t status = data[0];
+        const uint32_t length = messageLength(status, event.size);
+
+        if (length == 0 || length > event.size)
+            return;
+
+        if (status == 0xF0) {
+            writeDelta(tick);
+            putByte(0xF0);
+            writeVarLen(length - 1);
+            putDataBytes(data + 1, length - 2);
+            putByte(data[length - 1] == 0xF7 ? 0xF7 : data[length - 1] & 0x7F);
+        }
+        else if (status >= 0xF0) {
+            writeDelta(tick);
+            putByte(0xF7);
+            writeVarLen(length);
+            putByte(status);
+            putDataBytes(data + 1, length - 1);
+        }
+        else {
+            writeDelta(tick);
+            putByte(status);
+            putDataBytes(data + 1, length - 1);
+        }
+    }
+
+    /**
+      Write an escaped (0xF7) event with @a size bytes of @a data at @a tick.
+    */
+    void writeEscaped(uint64_t tick, const uint8_t* data, uint32_t size) {
+        if (fEndOfTrack || size > kMaxVarLen)
+            return;
+
+        writeDelta(tick);
+        putByte(0xF7);
+        writeVarLen(size);
+        putBytes(data, size);
+    }
+
+    /**
+      Write a meta event of @a type with @a size bytes of @a data at @a tick.
+      Events after an End of Track event are ignored.
+    */
+    void writeMeta(uint64_t tick, uint8_t type, const uint8_t* data, uint32_t size) {
+        if (fEndOfTrack || size > kMaxVarLen)
+            return;
+
+        writeDelta(tick);
+        putByte(0xFF);
+        putByte(type);
+        writeVarLen(size);
+        putBytes(data, size);
+        fEndOfTrack = type == 0x2F;
+    }
+
+private:
+    /**
+      Return the length of the message with @a status, which has @a size
+      bytes, or 0 for undefined status bytes and data bytes.
+    */
+    static uint32_t messageLength(uint8_t status, uint32_t size) noexcept {
+        if (status < 0x80)
+            return 0;
+
+        switch (status & 0xF0) {
+            case 0xC0:
+            case 0xD0:
+                return 2;
+            case 0xF0:
+                break;
+            default:
+                return 3;
+        }
+
+        switch (status) {
+            case 0xF0:
+                return size >= 2 ? size : 0;
+            case 0xF1:
+            case 0xF3:
+                return 2;
+            case 0xF2:
+                return 3;
+            case 0xF4:
+            case 0xF5:
+            case 0xF7:
+            case 0xF9:
+            case 0xFD:
+                return 0;
+            default:
+                return 1;
+        }
+    }
+
+    void writeDelta(uint64_t tick) {
+        // output events never go back in time
+        if (tick < fLastTick)
+            tick = fLastTick;
+
+        // longer gaps are shortened, a delta time can't express them
+        if (tick - fLastTick > kMaxVarLen)
+            tick = fLastTick + kMaxVarLen;
+
+        writeVarLen((uint32_t) (tick - fLastTick));
+        fLastTick = tick;
+    }
+
+    void writeVarLen(uint32_t value) {
+        uint8_t buf[4];
+        int i = 3;
+
+        if (value > kMaxVarLen)
+            value = kMaxVarLen;
+
+        buf[i] = value & 0x7F;
+
+        while ((value >>= 7) != 0)
+            buf[--i] = (value & 0x7F) | 0x80;
+
+        putBytes(buf + i, 4 - i);
+    }
+
+    inline void putByte(uint8_t byte) {
+        std::fputc(byte, fFile);
+        fTrackLength++;
+    }
+
+    inline void putBytes(const uint8_t* data, uint32_t size) {
+        if (size > 0)
+            std::fwrite(data, 1, size, fFile);
+
+        fTrackLength += size;
+    }
+
+    /**
+      Write @a size data bytes, with the top bit cleared.
+    */
+    void putDataBytes(const uint8_t* data, uint32_t size) {
+        for (uint32_t i=0; i < size; i++)
+            putByte(data[i] & 0x7F);
+    }
+
+    FILE* fFile;
+    long fTrackStart;
+    uint32_t fTrackLength;
+    uint64_t fLastTick;
+    bool fEndOfTrack;
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_FILE_WRITER_H
@@ -0,0 +1,191 @@
+/*
+ * Chain of MIDI processors configured from a file for midiomatic tools
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_PROCESSOR_CHAIN_H
+#define MIDI_PROCESSOR_CHAIN_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIProcessor.hpp"
+#include "MIDIToolProcessors.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Runs a list of processors one after another on each block, like the MIDI
+  Chain plugin, but with the stages read from a configuration file.
+
+  The file has one stage per line: the processor name, followed by
+  parameter assignments. Text after a '#' is a comment. The rules of a
+  'rules' stage are read from the file given with rules=PATH, relative to
+  the configuration file:
+
+      sysfilter filter_mode=1 sysex=1
+      pbtocc cc1=2 cc2=3
+      rules rules=live.rules
+*/
+class MidiProcessorChain {
+public:
+    MidiProcessorChain() noexcept {}
+
+    ~MidiProcessorChain() {
+        for (size_t i=0; i < fStages.size(); i++)
+            delete fStages[i];
+    }
+
+    /**
+      Add the stages listed in the configuration file at @a path.
+      Returns false and prints an error message if the file can't be read or
+      has errors.
+    */
+    bool loadConfig(const char* path) {
+        const char* slash = std::strrchr(path, '/');
+        const std::string dir = slash != nullptr ? std::string(path, slash - path + 1) : std::string();
+        FILE* file;
+        char line[1024];
+        uint32_t lineNumber = 0;
+        bool ok = true;
+
+        if ((file = std::fopen(path, "r")) == nullptr) {
+            std::fprintf(stderr, "Could not open configuration file '%s'.\n", path);
+            return false;
+        }
+
+        while (ok && std::fgets(line, sizeof(line), file) != nullptr) {
+            std::vector<const char*> params;
+            std::string rulesPath;
+            char* saveptr;
+            char* token;
+
+            lineNumber++;
+
+            if (char* comment = std::strchr(line, '#'))
+                *comment = '\0';
+
+            if ((token = strtok_r(line, " \t\r\n", &saveptr)) == nullptr)
+                continue;
+
+            const char* name = token;
+
+            while ((token = strtok_r(nullptr, " \t\r\n", &saveptr)) != nullptr) {
+                if (std::strncmp(token, "rules=", 6) == 0)
+                    rulesPath = token[6] == '/' ? std::string(token + 6) : dir + (token + 6);
+                else
+                    params.push_back(token);
+            }
+
+            MidiProcessor* processor = createConfiguredMidiProcessor(name, params,
+                                                                     rulesPath.empty() ? nullptr : rulesPath.c_str());
+
+            if (processor != nullptr) {
+                fStages.push_back(processor);
+                fNames.push_back(name);
+            }
+            else {
+                std::fprintf(stderr, "%s:%u: invalid stage.\n", path, lineNumber);
+                ok = false;
+            }
+        }
+
+        std::fclose(file);
+        return ok;
+    }
+
+    uint32_t getStageCount() const noexcept {
+        return (uint32_t) fStages.size();
+    }
+
+    MidiProcessor& getStage(uint32_t stage) const noexcept {
+        return *fStages[stage];
+    }
+
+    const char* getStageName(uint32_t stage) const noexcept {
+        return fNames[stage].c_str();
+    }
+
+    /**
+      Find a stage by its number, counting from 1, or by the name of its
+      processor. Returns -1 if there is no such stage.
+    */
+    int32_t findStage(const char* stage) const {
+        char* end;
+        const long number = std::strtol(stage, &end, 10);
+
+        if (end != stage && *end == '\0')
+            return number >= 1 && number <= (long) fStages.size() ? (int32_t) number - 1 : -1;
+
+        for (size_t i=0; i < fNames.size(); i++) {
+            if (fNames[i] == stage)
+                return (int32_t) i;
+        }
+
+        return -1;
+    }
+
+    /**
+      Run all stages on @a events and set @a output to the result.
+      Returns the number of output events. The output is valid until the
+      next call.
+    */
+    uint32_t process(const MidiEvent* events, uint32_t eventCount, const MidiEvent*& output) noexcept {
+        uint8_t buffer = 0;
+
+        output = events;
+
+        // ping-pong between the two buffers
+        for (size_t i=0; i < fStages.size(); i++) {
+            fBuffers[buffer].clear();
+            fStages[i]->process(output, eventCount, fBuffers[buffer]);
+            output = fBuffers[buffer].data();
+            eventCount = fBuffers[buffer].size();
+            buffer ^= 1;
+        }
+
+        return eventCount;
+    }
+
+    uint32_t getDroppedCount() const noexcept {
+        return fBuffers[0].getDroppedCount() + fBuffers[1].getDroppedCount();
+    }
+
+private:
+    std::vector<MidiProcessor*> fStages;
+    std::vector<std::string> fNames;
+    MidiEventBuffer fBuffers[2];
+};
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_PROCESSOR_CHAIN_H
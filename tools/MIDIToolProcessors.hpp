@@ -0,0 +1,280 @@
+/*
+ * Processor factory for midiomatic tools
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#ifndef MIDI_TOOL_PROCESSORS_H
+#define MIDI_TOOL_PROCESSORS_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DistrhoPlugin.hpp"
+#include "MIDIProcessor.hpp"
+
+#include "../plugins/MIDISysFilter/MIDISysFilterProcessor.hpp"
+#include "../plugins/MIDIPressureToCC/MIDIPressureToCCProcessor.hpp"
+#include "../plugins/MIDIPBToCC/MIDIPBToCCProcessor.hpp"
+#include "../plugins/MIDICCMapX4/MIDICCMapX4Processor.hpp"
+#include "../plugins/MIDICCToPressure/MIDICCToPressureProcessor.hpp"
+#include "../plugins/MIDIRules/MIDIRuleSet.hpp"
+
+START_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  MidiProcessor interface for a MIDI Rules rule set, so the tools can treat
+  it like the other processors. It has no parameters, the rules are set with
+  loadRules().
+*/
+class MidiRulesProcessor : public MidiProcessor {
+public:
+    uint32_t getParameterCount() const override {
+        return 0;
+    }
+
+    void initParameter(uint32_t, Parameter&) const override {}
+
+    float getParameterValue(uint32_t) const override {
+        return 0.0f;
+    }
+
+    void setParameterValue(uint32_t, float) override {}
+
+    /**
+      Compile the rules in @a text.
+      Returns false if any rule was invalid.
+    */
+    bool loadRules(const char* text) {
+        fRules.compile(text);
+        return fRules.getErrorCount() == 0;
+    }
+
+    template <class Sink>
+    void run(const MidiEvent* events, uint32_t eventCount, Sink& out) {
+        fRules.run(events, eventCount, out);
+    }
+
+    void process(const MidiEvent* events, uint32_t eventCount, MidiEventBuffer& out) override {
+        fRules.run(events, eventCount, out);
+    }
+
+private:
+    MidiRuleSet fRules;
+};
+
+// -----------------------------------------------------------------------
+
+struct MidiToolProcessorInfo {
+    const char* name;
+    const char* description;
+};
+
+/**
+  The processors available to the tools. The names are the symbols used by
+  the MIDI Chain plugin, plus "rules".
+*/
+static const MidiToolProcessorInfo midiToolProcessors[] = {
+    {"sysfilter", "MIDI Sys Filter"},
+    {"pressuretocc", "MIDI Pressure to CC"},
+    {"pbtocc", "MIDI PB to CC"},
+    {"ccmapx4", "MIDI CC Map X4"},
+    {"cctopressure", "MIDI CC to Pressure"},
+    {"rules", "MIDI Rules"}
+};
+
+static const uint32_t midiToolProcessorCount = sizeof(midiToolProcessors) / sizeof(MidiToolProcessorInfo);
+
+/**
+  Most events a processor can generate for one input event. The MIDI Rules
+  processor is the one with the largest fan-out. A MidiEventBuffer holding
+  the output of a block of input events never drops events if the block has
+  at most MidiEventBuffer::kCapacity / kMaxMidiFanOut events.
+*/
+static constexpr uint32_t kMaxMidiFanOut = MidiRuleSet::kMaxEmits + 1;
+
+/**
+  Create the processor called @a name.
+  Returns nullptr if there is no processor with that name.
+*/
+static inline MidiProcessor* createMidiProcessor(const char* name) {
+    if (std::strcmp(name, "sysfilter") == 0)
+        return new MidiSysFilterProcessor();
+    if (std::strcmp(name, "pressuretocc") == 0)
+        return new MidiPressureToCCProcessor();
+    if (std::strcmp(name, "pbtocc") == 0)
+        return new MidiPBToCCProcessor();
+    if (std::strcmp(name, "ccmapx4") == 0)
+        return new MidiCCMapX4Processor();
+    if (std::strcmp(name, "cctopressure") == 0)
+        return new MidiCCToPressureProcessor();
+    if (std::strcmp(name, "rules") == 0)
+        return new MidiRulesProcessor();
+
+    return nullptr;
+}
+
+/**
+  Find the parameter of @a processor with the given @a symbol.
+  Returns -1 if there is none.
+*/
+static inline int32_t findMidiProcessorParameter(const MidiProcessor& processor, const char* symbol) {
+    for (uint32_t i=0; i < processor.getParameterCount(); i++) {
+        Parameter parameter;
+        processor.initParameter(i, parameter);
+
+        if (std::strcmp(parameter.symbol.buffer(), symbol) == 0)
+            return (int32_t) i;
+    }
+
+    return -1;
+}
+
+/**
+  Apply a parameter assignment of the form "symbol=value" to @a processor.
+  Returns false and prints an error message if it is malformed or the
+  processor has no such parameter.
+*/
+static inline bool setMidiProcessorParameter(MidiProcessor& processor, const char* assignment) {
+    const char* equals = std::strchr(assignment, '=');
+    char* end;
+
+    if (equals == nullptr || equals == assignment) {
+        std::fprintf(stderr, "Invalid parameter assignment '%s', expected SYMBOL=VALUE.\n", assignment);
+        return false;
+    }
+
+    const std::string symbol(assignment, equals - assignment);
+    const float value = std::strtof(equals + 1, &end);
+    const int32_t index = findMidiProcessorParameter(processor, symbol.c_str());
+
+    if (end == equals + 1 || *end != '\0') {
+        std::fprintf(stderr, "Invalid value in parameter assignment '%s'.\n", assignment);
+        return false;
+    }
+
+    if (index < 0) {
+        std::fprintf(stderr, "Unknown parameter '%s'.\n", symbol.c_str());
+        return false;
+    }
+
+    processor.setParameterValue((uint32_t) index, value);
+    return true;
+}
+
+/**
+  Read the file at @a path and compile it as the rules of @a processor, which
+  must be a MidiRulesProcessor.
+  Returns false and prints an error message if this fails.
+*/
+static inline bool loadMidiProcessorRules(MidiProcessor& processor, const char* path) {
+    MidiRulesProcessor* rules = dynamic_cast<MidiRulesProcessor*>(&processor);
+    FILE* file;
+    std::string text;
+    char buf[4096];
+    size_t len;
+
+    if (rules == nullptr) {
+        std::fprintf(stderr, "Only the 'rules' processor takes a rules file.\n");
+        return false;
+    }
+
+    if ((file = std::fopen(path, "r")) == nullptr) {
+        std::fprintf(stderr, "Could not open rules file '%s'.\n", path);
+        return false;
+    }
+
+    while ((len = std::fread(buf, 1, sizeof(buf), file)) > 0)
+        text.append(buf, len);
+
+    std::fclose(file);
+
+    if (!rules->loadRules(text.c_str()))
+        std::fprintf(stderr, "Warning: invalid rules in '%s' are ignored.\n", path);
+
+    return true;
+}
+
+/**
+  Create the processor @a name, apply the parameter assignments @a params
+  and load the rules file at @a rulesPath, if not nullptr.
+  Returns nullptr and prints an error message if any of this fails.
+*/
+static inline MidiProcessor* createConfiguredMidiProcessor(const char* name, const std::vector<const char*>& params,
+                                                            const char* rulesPath) {
+    MidiProcessor* processor = createMidiProcessor(name);
+
+    if (processor == nullptr) {
+        std::fprintf(stderr, "Unknown processor '%s', use --list to show the available ones.\n", name);
+        return nullptr;
+    }
+
+    for (size_t i=0; i < params.size(); i++) {
+        if (!setMidiProcessorParameter(*processor, params[i])) {
+            delete processor;
+            return nullptr;
+        }
+    }
+
+    if (rulesPath != nullptr && !loadMidiProcessorRules(*processor, rulesPath)) {
+        delete processor;
+        return nullptr;
+    }
+
+    return processor;
+}
+
+/**
+  Print the available processors and their parameters to @a out.
+*/
+static inline void listMidiProcessors(FILE* out) {
+    for (uint32_t p=0; p < midiToolProcessorCount; p++) {
+        MidiProcessor* processor = createMidiProcessor(midiToolProcessors[p].name);
+
+        std::fprintf(out, "%s - %s\n", midiToolProcessors[p].name, midiToolProcessors[p].description);
+
+        for (uint32_t i=0; i < processor->getParameterCount(); i++) {
+            Parameter parameter;
+            processor->initParameter(i, parameter);
+            std::fprintf(out, "    %-24s %s (%g-%g, default: %g)\n", parameter.symbol.buffer(),
+                         parameter.name.buffer(), parameter.ranges.min, parameter.ranges.max,
+                         parameter.ranges.def);
+        }
+
+        if (std::strcmp(midiToolProcessors[p].name, "rules") == 0)
+            std::fprintf(out, "    (rules are read from the file given with --rules)\n");
+
+        delete processor;
+    }
+}
+
+// -----------------------------------------------------------------------
+
+END_NAMESPACE_DISTRHO
+
+#endif  // #ifndef MIDI_TOOL_PROCESSORS_H
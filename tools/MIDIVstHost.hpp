@@ -0,0 +1,260 @@
+/*
+ * Minimal VST2 host ABI and test data for the midiomatic test hosts
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#ifndef MIDI_VST_HOST_H
+#define MIDI_VST_HOST_H
+
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <dlfcn.h>
+
+/*
+  Only the parts of the VST2 ABI used by midiomatic-rtcheck and
+  midiomatic-plugbench are declared here.
+*/
+
+// -----------------------------------------------------------------------
+// VST2 ABI
+
+struct AEffect;
+
+typedef intptr_t (*VstHostCallback)(AEffect*, int32_t, int32_t, intptr_t, void*, float);
+typedef AEffect* (*VstPluginMain)(VstHostCallback);
+
+struct AEffect {
+    int32_t magic;
+    intptr_t (*dispatcher)(AEffect*, int32_t, int32_t, intptr_t, void*, float);
+    void (*process)(AEffect*, float**, float**, int32_t);
+    void (*setParameter)(AEffect*, int32_t, float);
+    float (*getParameter)(AEffect*, int32_t);
+    int32_t numPrograms;
+    int32_t numParams;
+    int32_t numInputs;
+    int32_t numOutputs;
+    int32_t flags;
+    intptr_t reserved1;
+    intptr_t reserved2;
+    int32_t initialDelay;
+    int32_t realQualities;
+    int32_t offQualities;
+    float ioRatio;
+    void* object;
+    void* user;
+    int32_t uniqueID;
+    int32_t version;
+    void (*processReplacing)(AEffect*, float**, float**, int32_t);
+    void (*processDoubleReplacing)(AEffect*, double**, double**, int32_t);
+    char future[56];
+};
+
+struct VstMidiEvent {
+    int32_t type;
+    int32_t byteSize;
+    int32_t deltaFrames;
+    int32_t flags;
+    int32_t noteLength;
+    int32_t noteOffset;
+    char midiData[4];
+    char detune;
+    char noteOffVelocity;
+    char reserved1;
+    char reserved2;
+};
+
+struct VstTimeInfo {
+    double samplePos;
+    double sampleRate;
+    double nanoSeconds;
+    double ppqPos;
+    double tempo;
+    double barStartPos;
+    double cycleStartPos;
+    double cycleEndPos;
+    int32_t timeSigNumerator;
+    int32_t timeSigDenominator;
+    int32_t smpteOffset;
+    int32_t smpteFrameRate;
+    int32_t samplesToNextClock;
+    int32_t flags;
+};
+
+static constexpr int32_t kEffectMagic = ('V' << 24) | ('s' << 16) | ('t' << 8) | 'P';
+static constexpr int32_t kEffFlagsProgramChunks = 1 << 5;
+static constexpr int32_t kVstMidiType = 1;
+static constexpr int32_t kVstTransportChanged = 1;
+static constexpr int32_t kVstTransportPlaying = 2;
+static constexpr int32_t kVstPpqPosValid = 1 << 9;
+static constexpr int32_t kVstTempoValid = 1 << 10;
+static constexpr int32_t kVstBarsValid = 1 << 11;
+static constexpr int32_t kVstTimeSigValid = 1 << 13;
+
+enum {
+    effOpen = 0,
+    effClose = 1,
+    effSetProgram = 2,
+    effSetSampleRate = 10,
+    effSetBlockSize = 11,
+    effMainsChanged = 12,
+    effGetChunk = 23,
+    effSetChunk = 24,
+    effProcessEvents = 25,
+    effStartProcess = 71,
+    effStopProcess = 72
+};
+
+enum {
+    audioMasterVersion = 1,
+    audioMasterGetTime = 7,
+    audioMasterProcessEvents = 8,
+    audioMasterGetSampleRate = 16,
+    audioMasterGetBlockSize = 17,
+    audioMasterGetCurrentProcessLevel = 23,
+    audioMasterCanDo = 37
+};
+
+/**
+  A VstEvents list with room for @a N events.
+*/
+template <uint32_t N>
+struct VstEventList {
+    int32_t numEvents;
+    intptr_t reserved;
+    VstMidiEvent* events[N];
+};
+
+// -----------------------------------------------------------------------
+// Host
+
+/**
+  Answer audioMasterCanDo for a host, which sends and receives MIDI events
+  and provides the time info.
+*/
+static inline intptr_t vstHostCanDo(const char* feature) {
+    if (feature != nullptr && (std::strcmp(feature, "sendVstEvents") == 0
+            || std::strcmp(feature, "sendVstMidiEvent") == 0
+            || std::strcmp(feature, "receiveVstEvents") == 0
+            || std::strcmp(feature, "receiveVstMidiEvent") == 0
+            || std::strcmp(feature, "sendVstTimeInfo") == 0))
+        return 1;
+    return 0;
+}
+
+/**
+  Load the VST2 plugin at @a path and create an instance of it, which calls
+  @a callback. The library handle is returned in @a lib, if @a lib was null,
+  or the library in @a lib is used. Returns null and prints a message if the
+  plugin could not be loaded.
+*/
+static inline AEffect* loadVstPlugin(const char* path, VstHostCallback callback, void*& lib) {
+    if (lib == nullptr) {
+        lib = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+
+        if (lib == nullptr) {
+            std::fprintf(stderr, "%s: %s\n", path, dlerror());
+            return nullptr;
+        }
+    }
+
+    VstPluginMain pluginMain = (VstPluginMain) dlsym(lib, "VSTPluginMain");
+
+    if (pluginMain == nullptr)
+        pluginMain = (VstPluginMain) dlsym(lib, "main");
+
+    if (pluginMain == nullptr) {
+        std::fprintf(stderr, "%s: not a VST2 plugin\n", path);
+        return nullptr;
+    }
+
+    AEffect* effect = pluginMain(callback);
+
+    if (effect == nullptr || effect->magic != kEffectMagic || effect->processReplacing == nullptr) {
+        std::fprintf(stderr, "%s: could not create the plugin instance\n", path);
+        return nullptr;
+    }
+
+    return effect;
+}
+
+// -----------------------------------------------------------------------
+// States
+
+static inline std::string base64Encode(const uint8_t* data, uint32_t size) {
+    static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string result;
+
+    for (uint32_t i=0; i < size; i += 3) {
+        const uint32_t value = (data[i] << 16) | (i + 1 < size ? data[i + 1] << 8 : 0)
+            | (i + 2 < size ? data[i + 2] : 0);
+
+        result += chars[(value >> 18) & 0x3F];
+        result += chars[(value >> 12) & 0x3F];
+        result += i + 1 < size ? chars[(value >> 6) & 0x3F] : '=';
+        result += i + 2 < size ? chars[value & 0x3F] : '=';
+    }
+
+    return result;
+}
+
+static inline void appendState(std::string& chunk, const char* key, const std::string& value) {
+    chunk.append(key);
+    chunk += '\0';
+    chunk.append(value);
+    chunk += '\0';
+}
+
+/**
+  A state chunk in the format of the DPF VST wrapper ("key\0value\0..."), with
+  the states of the plugins, which have any. Plugins ignore the keys, which
+  are not theirs.
+*/
+static inline std::string makeStateChunk(uint32_t variant) {
+    static const char* const rules[] = {
+        "cc 7 : map cc 11\nnoteon/10 36 : emit pc/10 5\ncc 1 : map cc 1 d2>127-0\npc : drop",
+        "noteon : emit noteon d1 d2; noteon : emit cc 1 d2; noteon : emit pb 0 d2\n"
+        "cc 1-127 : emit cc d1>127-0 d2; pb : map pressure d2\nthis is not a rule",
+        ""
+    };
+    std::string chunk;
+    uint8_t values[128];
+    char key[8];
+
+    appendState(chunk, "rules", rules[variant % 3]);
+
+    for (uint32_t ch=0; ch < 16; ch++) {
+        for (uint32_t cc=0; cc < 128; cc++)
+            values[cc] = (uint8_t) ((cc + ch + variant) % 128);
+
+        std::snprintf(key, sizeof(key), "ch-%02u", ch);
+        appendState(chunk, key, variant % 3 == 2 ? std::string("false") : base64Encode(values, 128));
+    }
+
+    return chunk;
+}
+
+#endif  // #ifndef MIDI_VST_HOST_H
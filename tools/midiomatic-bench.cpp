@@ -0,0 +1,940 @@
+/*
+ * Benchmarks of the midiomatic plugin cores
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MIDIBenchmark.hpp"
+#include "MIDIBenchReference.hpp"
+#include "MIDIToolProcessors.hpp"
+
+USE_NAMESPACE_DISTRHO
+
+struct BenchOptions {
+    uint32_t events;
+    uint32_t blockEvents;
+    uint32_t blockFrames;
+    uint32_t repeat;
+    uint32_t instances;
+    uint32_t threads;
+
+    BenchOptions() noexcept
+        : events(1000000), blockEvents(64), blockFrames(256), repeat(5), instances(32),
+          threads(std::max(2u, std::thread::hardware_concurrency())) {}
+};
+
+static void usage(FILE* out);
+
+// -----------------------------------------------------------------------
+// Specialized run() kernels
+
+struct KernelCase {
+    const char* processor;
+    const char* description;
+    const char* params[5];
+};
+
+static const KernelCase kernelCases[] = {
+    {"pbtocc", "defaults", {nullptr}},
+    {"pbtocc", "keep original", {"keep_original=1", nullptr}},
+    {"pbtocc", "inverted PB range", {"pb_min=4096", "pb_max=-4096", nullptr}},
+    {"pbtocc", "channel 1 only", {"channelf=1", nullptr}},
+    {"ccmapx4", "1 destination", {"cc1_mode=1", nullptr}},
+    {"ccmapx4", "4 destinations", {"cc1_mode=1", "cc2_mode=2", "cc3_mode=1", "cc4_mode=2", nullptr}},
+    {"ccmapx4", "2 dest., keep original", {"keep_original=1", "cc1_mode=1", "cc2_mode=2", nullptr}},
+    {"ccmapx4", "bypass", {"keep_original=1", nullptr}}
+};
+
+static void printKernelResult(const char* label, const char* kernel, const BenchResult& result,
+                              const BenchCounters& counters, const char* note) {
+    std::printf("%-34s %-12s %8.2f", label, kernel, result.nsPerEvent);
+
+    if (counters.isAvailable())
+        std::printf(" %9.1f %9.2f %9.3f", result.instructionsPerEvent, result.branchesPerEvent,
+                    result.branchMissesPerEvent);
+    else
+        std::printf(" %9s %9s %9s", "-", "-", "-");
+
+    std::printf("  %s\n", note);
+}
+
+/**
+  Time the processor specialized for the parameters of @a kernelCase and the
+  generic loop it replaced on the same events.
+  Returns false if the two don't generate the same number of events.
+*/
+template <class Processor, class Reference>
+static bool benchKernelCase(const KernelCase& kernelCase, const std::vector<MidiEvent>& events,
+                            const BenchOptions& options, BenchCounters& counters) {
+    Processor processor;
+    char label[64];
+
+    for (uint32_t i=0; kernelCase.params[i] != nullptr; i++)
+        setMidiProcessorParameter(processor, kernelCase.params[i]);
+
+    Reference reference(processor);
+    const BenchResult generic = benchKernel(reference, events, options.blockEvents, options.repeat, counters);
+    const BenchResult specialized = benchKernel(processor, events, options.blockEvents, options.repeat, counters);
+    const bool sameCount = generic.eventsOut == specialized.eventsOut;
+
+    std::snprintf(label, sizeof(label), "%s: %s", kernelCase.processor, kernelCase.description);
+    printKernelResult(label, "generic", generic, counters, "");
+    printKernelResult("", "specialized", specialized, counters,
+                      !sameCount ? "EVENT COUNT DIFFERS"
+                      : generic.checksum == specialized.checksum ? "same output" : "values differ");
+    return sameCount;
+}
+
+/**
+  Compare the run() kernels of MIDI PB to CC and MIDI CC Map X4, which are
+  specialized on the parameters, with the generic loop, which tests them
+  per event.
+*/
+static int benchKernels(const BenchOptions& options) {
+    std::vector<MidiEvent> pbEvents, ccEvents;
+    BenchCounters counters;
+    BenchRandom random;
+    bool ok = true;
+
+    // half of the events match, on random channels, so the branches are unpredictable
+    makeBenchEvents(pbEvents, options.events, options.blockEvents, options.blockFrames,
+                    MIDI_PITCH_BEND, 0xFF, 50, random);
+    makeBenchEvents(ccEvents, options.events, options.blockEvents, options.blockFrames,
+                    MIDI_CONTROL_CHANGE, 1, 50, random);
+
+    std::printf("%u events in blocks of %u, best of %u runs%s\n\n", options.events, options.blockEvents,
+                options.repeat, counters.isAvailable() ? "" : " (no hardware counters available)");
+    std::printf("%-34s %-12s %8s %9s %9s %9s\n", "case", "kernel", "ns/event", "instr/ev", "branch/ev",
+                "miss/ev");
+
+    for (uint32_t i=0; i < sizeof(kernelCases) / sizeof(kernelCases[0]); i++) {
+        const KernelCase& kernelCase(kernelCases[i]);
+
+        if (std::strcmp(kernelCase.processor, "pbtocc") == 0)
+            ok = benchKernelCase<MidiPBToCCProcessor, MidiPBToCCReference>(kernelCase, pbEvents, options,
+                                                                            counters) && ok;
+        else
+            ok = benchKernelCase<MidiCCMapX4Processor, MidiCCMapX4Reference>(kernelCase, ccEvents, options,
+                                                                              counters) && ok;
+    }
+
+    return ok ? 0 : 1;
+}
+
+// -----------------------------------------------------------------------
+// Range mapping
+
+struct MappingCase {
+    const char* description;
+    int32_t imin, imax, omin, omax;
+    int32_t vmin, vmax;
+};
+
+static const MappingCase mappingCases[] = {
+    {"CC 0..127 -> 20..100", 0, 127, 20, 100, 0, 127},
+    {"CC 100..20 -> 0..127", 100, 20, 0, 127, 0, 127},
+    {"CC 0..127 -> 127..0", 0, 127, 127, 0, 0, 127},
+    {"PB 0..8191 -> 0..127", 0, 8191, 0, 127, 0, 8191},
+    {"PB -1..-8192 -> 0..127", -1, -8192, 0, 127, -8192, -1},
+    {"PB 2000..8191 -> 64..0", 2000, 8191, 64, 0, -8192, 8191}
+};
+
+/**
+  Time @a map over all @a values, @a repeat times, and return the best time
+  per value in ns. The sum of the results is added to @a sum.
+*/
+template <class Map>
+static double benchMapping(const std::vector<int32_t>& values, uint32_t repeat, Map map, int64_t& sum) {
+    double best = 0.0;
+
+    for (uint32_t r=0; r < repeat; r++) {
+        int64_t total = 0;
+        const double start = benchNow();
+
+        for (size_t i=0; i < values.size(); i++)
+            total += map(values[i]);
+
+        const double seconds = benchNow() - start;
+
+        if (r == 0 || seconds < best)
+            best = seconds;
+
+        sum += total;
+    }
+
+    return 1e9 * best / values.size();
+}
+
+/**
+  Compare the range mapping of the old MAP() macro, called with float (as in
+  MIDI PB to CC) and with integer arguments, with mapRange(). mapRange() must
+  give the same result as the integer macro for every input value.
+*/
+static int benchMappings(const BenchOptions& options) {
+    BenchRandom random;
+    bool ok = true;
+    int64_t sum = 0;
+
+    std::printf("%u values per case, best of %u runs, ns/value\n\n", options.events, options.repeat);
+    std::printf("%-26s %12s %12s %12s  %s\n", "case", "MAP (float)", "MAP (int)", "mapRange()", "check");
+
+    for (uint32_t c=0; c < sizeof(mappingCases) / sizeof(mappingCases[0]); c++) {
+        const MappingCase& mc(mappingCases[c]);
+        const float fmin = (float) mc.omin, fmax = (float) mc.omax;
+        std::vector<int32_t> values(options.events);
+        uint32_t mismatches = 0;
+
+        for (int32_t v=mc.vmin; v <= mc.vmax; v++) {
+            if (mapRange<int32_t>(v, mc.imin, mc.imax, mc.omin, mc.omax) != REF_MAP(v, mc.imin, mc.imax, mc.omin, mc.omax))
+                mismatches++;
+        }
+
+        for (size_t i=0; i < values.size(); i++)
+            values[i] = mc.vmin + (int32_t) random.below((uint32_t) (mc.vmax - mc.vmin + 1));
+
+        const double macroFloat = benchMapping(values, options.repeat, [&](int32_t v) {
+            return (int32_t) (uint8_t) REF_MAP(v, mc.imin, mc.imax, fmin, fmax);
+        }, sum);
+        const double macroInt = benchMapping(values, options.repeat, [&](int32_t v) {
+            return REF_MAP(v, mc.imin, mc.imax, mc.omin, mc.omax);
+        }, sum);
+        const double function = benchMapping(values, options.repeat, [&](int32_t v) {
+            return mapRange<int32_t>(v, mc.imin, mc.imax, mc.omin, mc.omax);
+        }, sum);
+
+        std::printf("%-26s %12.2f %12.2f %12.2f  ", mc.description, macroFloat, macroInt, function);
+
+        if (mismatches == 0) {
+            std::printf("exact\n");
+        }
+        else {
+            std::printf("%u VALUES DIFFER\n", mismatches);
+            ok = false;
+        }
+    }
+
+    // keep the compiler from dropping the loops
+    if (sum == 42)
+        std::printf("\n");
+
+    return ok ? 0 : 1;
+}
+
+// -----------------------------------------------------------------------
+// Multi-instance scaling
+
+/**
+  Construct a @a Processor in the memory at @a where.
+*/
+template <class Processor>
+static MidiProcessor* placeProcessor(void* where) {
+    return new (where) Processor();
+}
+
+struct ScalingConfig {
+    const char* processor;
+    size_t size;
+    size_t align;
+    MidiProcessor* (*place)(void* where);
+    uint8_t statusType;
+    uint8_t data1;
+    const char* rules;
+    const char* params[6];
+};
+
+#define SCALING_PROCESSOR(Processor) sizeof(Processor), alignof(Processor), placeProcessor<Processor>
+
+static const ScalingConfig scalingConfigs[] = {
+    {"ccmapx4", SCALING_PROCESSOR(MidiCCMapX4Processor), MIDI_CONTROL_CHANGE, 1, nullptr,
+     {"cc1_mode=1", "cc1_filterdups=1", "cc2_mode=2", "cc3_mode=1", "cc4_mode=2", nullptr}},
+    {"pbtocc", SCALING_PROCESSOR(MidiPBToCCProcessor), MIDI_PITCH_BEND, 0xFF, nullptr, {nullptr}},
+    {"pressuretocc", SCALING_PROCESSOR(MidiPressureToCCProcessor), MIDI_CHANNEL_PRESSURE, 0xFF, nullptr,
+     {nullptr}},
+    {"cctopressure", SCALING_PROCESSOR(MidiCCToPressureProcessor), MIDI_CONTROL_CHANGE, 0xFF, nullptr,
+     {nullptr}},
+    {"sysfilter", SCALING_PROCESSOR(MidiSysFilterProcessor), MIDI_PROGRAM_CHANGE, 0xFF, nullptr, {nullptr}},
+    {"rules", SCALING_PROCESSOR(MidiRulesProcessor), MIDI_NOTE_ON, 0xFF,
+     "noteon : emit cc 1 d2\ncc 1-63 : map cc 7\npc : drop", {nullptr}}
+};
+
+#undef SCALING_PROCESSOR
+
+static constexpr uint32_t kScalingConfigCount = sizeof(scalingConfigs) / sizeof(scalingConfigs[0]);
+
+static_assert((CACHE_LINE_SIZE & (CACHE_LINE_SIZE - 1)) == 0, "the cache line size must be a power of two");
+
+/**
+  One processor instance of the scaling benchmark with its output. Only the
+  worker thread it is assigned to touches it while running.
+*/
+struct ScalingInstance {
+    MidiProcessor* processor;
+    MidiEventBuffer* out;
+    BenchSink sink;
+    char padding[CACHE_LINE_SIZE];
+};
+
+static_assert(sizeof(ScalingInstance) - offsetof(ScalingInstance, padding) >= CACHE_LINE_SIZE,
+              "the sinks of adjacent instances may share a cache line");
+
+struct ScalingResult {
+    double eventsPerSecond;
+    double latencyMedian;
+    double latency99;
+    double latencyMax;
+    uint32_t mismatches;
+};
+
+static inline size_t alignUp(size_t offset, size_t align) {
+    return (offset + align - 1) / align * align;
+}
+
+/**
+  One block of memory, which holds the processors of the scaling benchmark.
+  In the "contiguous" layout, each processor directly follows the previous
+  one, so the state of instances run by different threads shares cache
+  lines. In the "aligned" layout, each processor starts on a cache line of
+  its own and is followed by the padding up to the next one, so no two
+  instances share a cache line.
+
+  Instance i is of the scaling configuration (@a firstConfig + i) modulo the
+  number of configurations.
+*/
+class ScalingArena {
+public:
+    ScalingArena(uint32_t numInstances, bool aligned, uint32_t firstConfig = 0)
+        : fOffsets(numInstances),
+          fFirstConfig(firstConfig),
+          fAligned(aligned) {
+        size_t offset = 0;
+
+        for (uint32_t i=0; i < numInstances; i++) {
+            const ScalingConfig& config(scalingConfigs[(firstConfig + i) % kScalingConfigCount]);
+
+            offset = alignUp(offset, aligned ? CACHE_LINE_SIZE : config.align);
+            fOffsets[i] = offset;
+            offset += config.size;
+        }
+
+        fMemory.resize(alignUp(offset, CACHE_LINE_SIZE) + CACHE_LINE_SIZE);
+        fBase = fMemory.data() + (CACHE_LINE_SIZE - (uintptr_t) fMemory.data() % CACHE_LINE_SIZE)
+            % CACHE_LINE_SIZE;
+    }
+
+    void* at(uint32_t index) noexcept {
+        return fBase + fOffsets[index];
+    }
+
+    /**
+      The number of instances, which share a cache line with an instance run
+      by another of @a numThreads threads. Instance i is run by thread
+      i % @a numThreads.
+    */
+    uint32_t countSharedLines(uint32_t numThreads) const noexcept {
+        uint32_t shared = 0;
+
+        for (uint32_t i=1; i < fOffsets.size(); i++) {
+            const size_t lastByte = fOffsets[i - 1]
+                + scalingConfigs[(fFirstConfig + i - 1) % kScalingConfigCount].size - 1;
+
+            if (i % numThreads != (i - 1) % numThreads
+                    && lastByte / CACHE_LINE_SIZE == fOffsets[i] / CACHE_LINE_SIZE)
+                shared++;
+        }
+
+        return shared;
+    }
+
+    bool isAligned() const noexcept {
+        return fAligned;
+    }
+
+private:
+    std::vector<char> fMemory;
+    std::vector<size_t> fOffsets;
+    char* fBase;
+    uint32_t fFirstConfig;
+    bool fAligned;
+
+    ScalingArena(const ScalingArena&) = delete;
+    ScalingArena& operator=(const ScalingArena&) = delete;
+};
+
+static MidiProcessor* createScalingProcessor(const ScalingConfig& config, void* where) {
+    MidiProcessor* processor = config.place(where);
+
+    for (uint32_t i=0; config.params[i] != nullptr; i++)
+        setMidiProcessorParameter(*processor, config.params[i]);
+
+    if (config.rules != nullptr)
+        static_cast<MidiRulesProcessor*>(processor)->loadRules(config.rules);
+
+    return processor;
+}
+
+/**
+  Process all blocks of @a events with @a instance and fold the output into
+  its sink. The time of each process() call in ns is added to @a latencies,
+  if given.
+*/
+static void processScalingBlock(ScalingInstance& instance, const MidiEvent* events, uint32_t count,
+                                std::vector<float>* latencies) {
+    const double start = latencies != nullptr ? benchNow() : 0.0;
+
+    instance.out->clear();
+    instance.processor->process(events, count, *instance.out);
+
+    if (latencies != nullptr)
+        latencies->push_back((float) (1e9 * (benchNow() - start)));
+
+    for (uint32_t i=0; i < instance.out->size(); i++)
+        instance.sink.write(instance.out->data()[i]);
+}
+
+/**
+  Run @a numInstances instances of the scaling configurations with
+  @a numThreads worker threads, which each process every @a numThreads-th
+  instance block by block, like a host running several plugins per thread.
+  The processors are placed in @a arena. The output of every instance is
+  compared with @a reference, the checksum of its configuration processed by
+  a single instance alone.
+*/
+static ScalingResult runScaling(const std::vector<std::vector<MidiEvent> >& streams,
+                                const std::vector<uint64_t>& reference, ScalingArena& arena,
+                                uint32_t numInstances, uint32_t numThreads, uint32_t blockEvents) {
+    std::vector<ScalingInstance> instances(numInstances);
+    std::vector<std::vector<float> > latencies(numThreads);
+    std::vector<std::thread> threads;
+    ScalingResult result;
+    const uint32_t count = (uint32_t) streams[0].size();
+
+    for (uint32_t i=0; i < numInstances; i++) {
+        instances[i].out = new MidiEventBuffer();
+        instances[i].processor = createScalingProcessor(scalingConfigs[i % kScalingConfigCount], arena.at(i));
+    }
+
+    auto worker = [&](uint32_t first) {
+        std::vector<float>& workerLatencies(latencies[first]);
+
+        workerLatencies.reserve((count / blockEvents + 1) * (numInstances / numThreads + 1));
+
+        for (uint32_t start=0; start < count; start += blockEvents) {
+            const uint32_t blockCount = count - start < blockEvents ? count - start : blockEvents;
+
+            for (uint32_t i=first; i < numInstances; i += numThreads)
+                processScalingBlock(instances[i], streams[i % kScalingConfigCount].data() + start, blockCount,
+                                    &workerLatencies);
+        }
+    };
+
+    const double start = benchNow();
+
+    for (uint32_t t=1; t < numThreads; t++)
+        threads.push_back(std::thread(worker, t));
+
+    worker(0);
+
+    for (size_t t=0; t < threads.size(); t++)
+        threads[t].join();
+
+    const double seconds = benchNow() - start;
+    std::vector<float> all;
+
+    for (uint32_t t=0; t < numThreads; t++)
+        all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+
+    std::sort(all.begin(), all.end());
+
+    result.eventsPerSecond = (double) count * numInstances / seconds;
+    result.latencyMedian = all[all.size() / 2];
+    result.latency99 = all[all.size() * 99 / 100];
+    result.latencyMax = all.back();
+    result.mismatches = 0;
+
+    for (uint32_t i=0; i < numInstances; i++) {
+        if (instances[i].sink.checksum != reference[i % kScalingConfigCount])
+            result.mismatches++;
+
+        instances[i].processor->~MidiProcessor();
+        delete instances[i].out;
+    }
+
+    return result;
+}
+
+/**
+  Run many processor instances with 1, 2, 4, ... worker threads and report
+  the throughput of all of them together and the time of the process() calls
+  of single instances, once with the processors packed into contiguous
+  memory and once with each on cache lines of its own. Fails if the output
+  of any instance differs from that of an instance run alone, which means
+  there is state shared between the instances.
+
+  Whether the instances share cache lines is decided from their layout, not
+  from the timings, which are only reported: the aligned layout must not
+  share any, the contiguous one shows what false sharing costs.
+  midiomatic-plugbench does the same for the complete plugins.
+*/
+static int benchScaling(const BenchOptions& options) {
+    std::vector<std::vector<MidiEvent> > streams(kScalingConfigCount);
+    std::vector<uint64_t> reference(kScalingConfigCount);
+    const uint32_t count = options.events / options.instances;
+    BenchRandom random;
+    bool ok = true;
+
+    if (count == 0) {
+        std::printf("Less than one event per instance.\n");
+        return 1;
+    }
+
+    for (uint32_t c=0; c < kScalingConfigCount; c++) {
+        const ScalingConfig& config(scalingConfigs[c]);
+        ScalingArena arena(1, true, c);
+        ScalingInstance instance;
+
+        makeBenchEvents(streams[c], count, options.blockEvents, options.blockFrames, config.statusType,
+                        config.data1, 50, random);
+
+        instance.processor = createScalingProcessor(config, arena.at(0));
+        instance.out = new MidiEventBuffer();
+
+        for (uint32_t start=0; start < count; start += options.blockEvents)
+            processScalingBlock(instance, streams[c].data() + start,
+                                count - start < options.blockEvents ? count - start : options.blockEvents,
+                                nullptr);
+
+        reference[c] = instance.sink.checksum;
+        instance.processor->~MidiProcessor();
+        delete instance.out;
+    }
+
+    std::printf("%u instances, %u events each in blocks of %u, best of %u runs, up to %u threads\n\n",
+                options.instances, count, options.blockEvents, options.repeat, options.threads);
+    std::printf("%-10s %7s %12s %8s %10s %10s %10s %7s  %s\n", "layout", "threads", "Mevents/s", "speedup",
+                "p50 ns", "p99 ns", "max ns", "shared", "check");
+
+    double single = 0.0;
+    ScalingArena contiguous(options.instances, false);
+    ScalingArena aligned(options.instances, true);
+    ScalingArena* const arenas[] = {&contiguous, &aligned};
+
+    for (uint32_t threads=1; threads <= options.threads; threads *= 2) {
+        for (uint32_t layout=0; layout < 2; layout++) {
+            ScalingArena& arena(*arenas[layout]);
+            const uint32_t sharedLines = arena.countSharedLines(threads);
+            ScalingResult best;
+            uint32_t mismatches = 0;
+
+            std::memset(&best, 0, sizeof(best));
+
+            for (uint32_t r=0; r < options.repeat; r++) {
+                const ScalingResult result = runScaling(streams, reference, arena, options.instances, threads,
+                                                        options.blockEvents);
+
+                if (r == 0 || result.eventsPerSecond > best.eventsPerSecond)
+                    best = result;
+
+                if (result.mismatches > mismatches)
+                    mismatches = result.mismatches;
+            }
+
+            if (threads == 1 && layout == 0)
+                single = best.eventsPerSecond;
+
+            std::printf("%-10s %7u %12.2f %8.2f %10.0f %10.0f %10.0f %7u  ",
+                        arena.isAligned() ? "aligned" : "contiguous", threads, best.eventsPerSecond / 1e6,
+                        best.eventsPerSecond / single, best.latencyMedian, best.latency99, best.latencyMax,
+                        sharedLines);
+
+            if (mismatches > 0) {
+                std::printf("%u INSTANCES DIFFER (SHARED STATE)\n", mismatches);
+                ok = false;
+            }
+            else if (arena.isAligned() && sharedLines > 0) {
+                std::printf("ALIGNED INSTANCES SHARE CACHE LINES\n");
+                ok = false;
+            }
+            else {
+                std::printf("ok\n");
+            }
+        }
+    }
+
+    return ok ? 0 : 1;
+}
+
+// -----------------------------------------------------------------------
+// Stress tests
+
+static constexpr uint32_t kStressBlockEvents = 4096;
+static constexpr uint32_t kStressSysExSize = 65536;
+
+struct StressCase {
+    const char* processor;
+    const char* description;
+    // 0 for random status and data bytes
+    uint8_t statusType;
+    // data byte 1, random if > 127
+    uint8_t data1;
+    // events per block alternate between these channels
+    uint8_t channels;
+    bool sysex;
+    // budget of output events per input event, which is checked
+    uint32_t maxFanOut;
+    // budget of worst-case ns per input event in a block, which is only reported,
+    // since the time depends on the machine and its load
+    double maxNsPerEvent;
+    std::string (*makeRules)();
+    const char* params[6];
+};
+
+/**
+  Eight "emit" rules and a "map" rule for every CC, and eight more "emit"
+  rules, which must be rejected.
+*/
+static std::string makeStressEmitRules() {
+    std::string rules;
+
+    for (int i=0; i < 16; i++)
+        rules += "cc : emit cc d1 d2\n";
+
+    return rules + "cc : map pb d2 d1\n";
+}
+
+/**
+  The maximum number of rules for one status byte, with only the last one
+  matching, so every event is checked against all of them.
+*/
+static std::string makeStressDispatchRules() {
+    std::string rules;
+
+    for (uint32_t i=1; i < MidiRuleSet::kMaxRules; i++)
+        rules += "noteon 0-126 0 : drop\n";
+
+    return rules + "noteon : map noteoff\n";
+}
+
+static const StressCase stressCases[] = {
+    {"rules", "16 emits + map, all match", MIDI_CONTROL_CHANGE, 0xFF, 16, false,
+     kMaxMidiFanOut, 400.0, makeStressEmitRules, {nullptr}},
+    {"rules", "128 rules for one status", MIDI_NOTE_ON, 127, 2, false,
+     1, 1000.0, makeStressDispatchRules, {nullptr}},
+    {"rules", "random bytes", 0, 0xFF, 16, false,
+     kMaxMidiFanOut, 400.0, makeStressEmitRules, {nullptr}},
+    {"ccmapx4", "4 destinations + original", MIDI_CONTROL_CHANGE, 1, 16, false, 5, 200.0, nullptr,
+     {"keep_original=1", "cc1_mode=1", "cc2_mode=2", "cc3_mode=1", "cc4_mode=2", nullptr}},
+    {"ccmapx4", "random bytes", 0, 0xFF, 16, false, 5, 200.0, nullptr,
+     {"keep_original=1", "cc1_mode=1", "cc2_mode=2", "cc3_mode=1", "cc4_mode=2", nullptr}},
+    {"pbtocc", "all PB + original", MIDI_PITCH_BEND, 0xFF, 16, false, 3, 200.0, nullptr,
+     {"keep_original=1", "cc2=3", nullptr}},
+    {"pressuretocc", "all pressure", MIDI_CHANNEL_PRESSURE, 0xFF, 16, false, 2, 200.0, nullptr, {nullptr}},
+    {"cctopressure", "all CC", MIDI_CONTROL_CHANGE, 0xFF, 16, false, 2, 200.0, nullptr, {nullptr}},
+    {"sysfilter", "64 KiB SysEx", MIDI_SYSTEM_EXCLUSIVE, 0, 1, true, 1, 200.0, nullptr, {nullptr}},
+    {"sysfilter", "random bytes", 0, 0xFF, 16, false, 1, 200.0, nullptr, {"filter_mode=1", nullptr}}
+};
+
+/**
+  Fill @a events with @a count events for @a stressCase: all of the case's
+  type, on channels alternating between the first @a stressCase.channels
+  ones, or with random status and data bytes of random sizes.
+*/
+static void makeStressEvents(std::vector<MidiEvent>& events, uint32_t count, const StressCase& stressCase,
+                             const uint8_t* sysex, BenchRandom& random) {
+    events.resize(count);
+
+    for (uint32_t i=0; i < count; i++) {
+        MidiEvent& ev(events[i]);
+
+        ev.frame = i % kStressBlockEvents / 16;
+        ev.dataExt = nullptr;
+
+        if (stressCase.sysex) {
+            ev.size = kStressSysExSize;
+            ev.dataExt = sysex;
+        }
+        else if (stressCase.statusType == 0) {
+            ev.size = 1 + random.below(MidiEvent::kDataSize);
+
+            for (uint32_t j=0; j < MidiEvent::kDataSize; j++)
+                ev.data[j] = (uint8_t) random.below(256);
+
+            ev.data[0] |= 0x80;
+        }
+        else {
+            ev.size = stressCase.statusType == MIDI_PROGRAM_CHANGE
+                || stressCase.statusType == MIDI_CHANNEL_PRESSURE ? 2 : 3;
+            ev.data[0] = stressCase.statusType | (uint8_t) (i % stressCase.channels);
+            ev.data[1] = stressCase.data1 > 127 ? (uint8_t) random.below(128) : stressCase.data1;
+            // changing values, so duplicate filters let everything through
+            ev.data[2] = (uint8_t) (i / stressCase.channels % 128);
+            ev.data[3] = 0;
+        }
+    }
+}
+
+/**
+  Run @a processor over @a events in blocks of kStressBlockEvents, @a repeat
+  times, and check the worst block against the fan-out budget of
+  @a stressCase. The worst-case time is the lowest of the passes' slowest
+  blocks and is only compared with the time budget in the report.
+*/
+template <class Processor>
+static bool runStressCase(Processor& processor, const StressCase& stressCase, const std::vector<MidiEvent>& events,
+                          uint32_t repeat) {
+    const uint32_t count = (uint32_t) events.size();
+    double worstNs = 0.0;
+    double maxFanOut = 0.0;
+    uint64_t eventsOut = 0;
+
+    for (uint32_t r=0; r < repeat; r++) {
+        double passWorstNs = 0.0;
+
+        eventsOut = 0;
+
+        for (uint32_t i=0; i < count; i += kStressBlockEvents) {
+            const uint32_t blockCount = count - i < kStressBlockEvents ? count - i : kStressBlockEvents;
+            BenchSink sink;
+            const double start = benchNow();
+
+            processor.run(events.data() + i, blockCount, sink);
+
+            const double ns = 1e9 * (benchNow() - start) / blockCount;
+
+            if (ns > passWorstNs)
+                passWorstNs = ns;
+
+            if ((double) sink.count / blockCount > maxFanOut)
+                maxFanOut = (double) sink.count / blockCount;
+
+            eventsOut += sink.count;
+        }
+
+        if (r == 0 || passWorstNs < worstNs)
+            worstNs = passWorstNs;
+    }
+
+    const bool fanOutOk = maxFanOut <= stressCase.maxFanOut;
+    const bool timeOk = worstNs <= stressCase.maxNsPerEvent;
+
+    std::printf("%-12s %-28s %10llu %6.2f/%-2u %8.1f/%-6.0f  %s\n", stressCase.processor,
+                stressCase.description, (unsigned long long) eventsOut, maxFanOut, stressCase.maxFanOut,
+                worstNs, stressCase.maxNsPerEvent,
+                !fanOutOk ? "TOO MANY EVENTS" : !timeOk ? "ok (over time budget)" : "ok");
+    return fanOutOk;
+}
+
+template <class Processor>
+static bool benchStressCase(const StressCase& stressCase, const std::vector<MidiEvent>& events, uint32_t repeat) {
+    Processor processor;
+
+    for (uint32_t i=0; stressCase.params[i] != nullptr; i++)
+        setMidiProcessorParameter(processor, stressCase.params[i]);
+
+    return runStressCase(processor, stressCase, events, repeat);
+}
+
+template <>
+bool benchStressCase<MidiRulesProcessor>(const StressCase& stressCase, const std::vector<MidiEvent>& events,
+                                         uint32_t repeat) {
+    MidiRulesProcessor processor;
+
+    processor.loadRules(stressCase.makeRules().c_str());
+    return runStressCase(processor, stressCase, events, repeat);
+}
+
+/**
+  Feed the processors pathological input, in blocks of thousands of events,
+  and check the events generated per input event against fixed budgets. The
+  worst-case time of a block per input event is reported with its budget,
+  but does not fail the check.
+*/
+static int benchStress(const BenchOptions& options) {
+    const uint32_t count = options.events > kStressBlockEvents ? options.events : kStressBlockEvents;
+    std::vector<uint8_t> sysex(kStressSysExSize, 0x55);
+    BenchRandom random;
+    bool ok = true;
+
+    sysex.front() = MIDI_SYSTEM_EXCLUSIVE;
+    sysex.back() = MIDI_END_OF_EXCLUSIVE;
+
+    std::printf("%u events in blocks of %u, worst block of the best of %u runs\n\n", count,
+                kStressBlockEvents, options.repeat);
+    std::printf("%-12s %-28s %10s %9s %15s  %s\n", "processor", "case", "events out", "fan-out",
+                "worst ns/event", "check");
+
+    for (uint32_t c=0; c < sizeof(stressCases) / sizeof(stressCases[0]); c++) {
+        const StressCase& stressCase(stressCases[c]);
+        std::vector<MidiEvent> events;
+
+        makeStressEvents(events, count, stressCase, sysex.data(), random);
+
+        if (std::strcmp(stressCase.processor, "rules") == 0)
+            ok = benchStressCase<MidiRulesProcessor>(stressCase, events, options.repeat) && ok;
+        else if (std::strcmp(stressCase.processor, "ccmapx4") == 0)
+            ok = benchStressCase<MidiCCMapX4Processor>(stressCase, events, options.repeat) && ok;
+        else if (std::strcmp(stressCase.processor, "pbtocc") == 0)
+            ok = benchStressCase<MidiPBToCCProcessor>(stressCase, events, options.repeat) && ok;
+        else if (std::strcmp(stressCase.processor, "pressuretocc") == 0)
+            ok = benchStressCase<MidiPressureToCCProcessor>(stressCase, events, options.repeat) && ok;
+        else if (std::strcmp(stressCase.processor, "cctopressure") == 0)
+            ok = benchStressCase<MidiCCToPressureProcessor>(stressCase, events, options.repeat) && ok;
+        else
+            ok = benchStressCase<MidiSysFilterProcessor>(stressCase, events, options.repeat) && ok;
+    }
+
+    return ok ? 0 : 1;
+}
+
+// -----------------------------------------------------------------------
+
+struct BenchMode {
+    const char* name;
+    int (*run)(const BenchOptions& options);
+    const char* description;
+};
+
+static const BenchMode benchModes[] = {
+    {"kernels", benchKernels, "specialized run() kernels vs. the generic per-event loop"},
+    {"mapping", benchMappings, "mapRange() vs. the MAP() macro"},
+    {"scaling", benchScaling, "many instances run by 1, 2, 4, ... threads"},
+    {"stress", benchStress, "worst-case time and output of pathological input"}
+};
+
+static const uint32_t benchModeCount = sizeof(benchModes) / sizeof(BenchMode);
+
+static void usage(FILE* out) {
+    std::fprintf(out,
+        "Usage: midiomatic-bench [OPTIONS] MODE...\n"
+        "\n"
+        "Benchmark the midiomatic MIDI processors. Modes:\n"
+        "\n");
+
+    for (uint32_t i=0; i < benchModeCount; i++)
+        std::fprintf(out, "  %-10s %s\n", benchModes[i].name, benchModes[i].description);
+
+    std::fprintf(out,
+        "\n"
+        "Options:\n"
+        "  -n, --events N        events per measurement (default: 1000000)\n"
+        "  -e, --block-events N  events per processing block (default: 64)\n"
+        "  -f, --block-frames N  frames per processing block (default: 256)\n"
+        "  -r, --repeat N        repetitions, the best one is reported (default: 5)\n"
+        "  -i, --instances N     processor instances in the scaling mode (default: 32)\n"
+        "  -t, --threads N       maximum number of threads in the scaling mode\n"
+        "                        (default: number of CPUs, at least 2)\n"
+        "  -h, --help            show this help\n"
+        "\n"
+        "The exit status is 1 if a check of any mode failed.\n");
+}
+
+int main(int argc, char** argv) {
+    static const struct option longOptions[] = {
+        {"events", required_argument, nullptr, 'n'},
+        {"block-events", required_argument, nullptr, 'e'},
+        {"block-frames", required_argument, nullptr, 'f'},
+        {"repeat", required_argument, nullptr, 'r'},
+        {"instances", required_argument, nullptr, 'i'},
+        {"threads", required_argument, nullptr, 't'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+    BenchOptions options;
+    int status = 0;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "n:e:f:r:i:t:h", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 'n':
+                options.events = (uint32_t) std::atoi(optarg);
+                break;
+            case 'e':
+                options.blockEvents = (uint32_t) std::atoi(optarg);
+                break;
+            case 'f':
+                options.blockFrames = (uint32_t) std::atoi(optarg);
+                break;
+            case 'r':
+                options.repeat = (uint32_t) std::atoi(optarg);
+                break;
+            case 'i':
+                options.instances = (uint32_t) std::atoi(optarg);
+                break;
+            case 't':
+                options.threads = (uint32_t) std::atoi(optarg);
+                break;
+            case 'h':
+                usage(stdout);
+                return 0;
+            default:
+                usage(stderr);
+                return 2;
+        }
+    }
+
+    if (optind >= argc || options.events == 0 || options.blockEvents == 0 || options.blockFrames == 0
+            || options.repeat == 0 || options.instances == 0 || options.threads == 0) {
+        usage(stderr);
+        return 2;
+    }
+
+    for (int i=optind; i < argc; i++) {
+        uint32_t mode = 0;
+
+        while (mode < benchModeCount && std::strcmp(argv[i], benchModes[mode].name) != 0)
+            mode++;
+
+        if (mode == benchModeCount) {
+            std::fprintf(stderr, "Unknown mode '%s'.\n", argv[i]);
+            usage(stderr);
+            return 2;
+        }
+    }
+
+    for (int i=optind; i < argc; i++) {
+        for (uint32_t mode=0; mode < benchModeCount; mode++) {
+            if (std::strcmp(argv[i], benchModes[mode].name) == 0) {
+                if (i > optind)
+                    std::printf("\n");
+
+                std::printf("== %s ==\n", benchModes[mode].name);
+
+                if (benchModes[mode].run(options) != 0)
+                    status = 1;
+            }
+        }
+    }
+
+    return status;
+}
@@ -0,0 +1,154 @@
+/*
+ * Raw MIDI byte stream filter using the midiomatic plugin cores
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <getopt.h>
+#include <vector>
+#include <unistd.h>
+
+#include "MIDIByteStream.hpp"
+#include "MIDIToolProcessors.hpp"
+
+USE_NAMESPACE_DISTRHO
+
+static volatile sig_atomic_t sStop = 0;
+
+static void stopHandler(int) {
+    sStop = 1;
+}
+
+static void usage(FILE* out) {
+    std::fprintf(out,
+        "Usage: midiomatic-filter [OPTIONS] PROCESSOR < INPUT > OUTPUT\n"
+        "\n"
+        "Run a raw MIDI byte stream from standard input through one of the midiomatic\n"
+        "MIDI processors and write the result to standard output, e.g.\n"
+        "\n"
+        "    midiomatic-filter sysfilter < /dev/snd/midiC1D0 > /dev/snd/midiC2D0\n"
+        "\n"
+        "Options:\n"
+        "  -p, --param SYMBOL=VALUE  set a processor parameter (repeatable)\n"
+        "  -r, --rules FILE          read the rules for the 'rules' processor from FILE\n"
+        "  -l, --list                list the processors and their parameters\n"
+        "  -q, --quiet               don't print event counts at the end\n"
+        "  -h, --help                show this help\n");
+}
+
+int main(int argc, char** argv) {
+    static const struct option longOptions[] = {
+        {"param", required_argument, nullptr, 'p'},
+        {"rules", required_argument, nullptr, 'r'},
+        {"list", no_argument, nullptr, 'l'},
+        {"quiet", no_argument, nullptr, 'q'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+    std::vector<const char*> params;
+    const char* rulesPath = nullptr;
+    struct sigaction action;
+    uint8_t buffer[1024];
+    bool quiet = false;
+    bool ok = true;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "p:r:lqh", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 'p':
+                params.push_back(optarg);
+                break;
+            case 'r':
+                rulesPath = optarg;
+                break;
+            case 'l':
+                listMidiProcessors(stdout);
+                return 0;
+            case 'q':
+                quiet = true;
+                break;
+            case 'h':
+                usage(stdout);
+                return 0;
+            default:
+                usage(stderr);
+                return 2;
+        }
+    }
+
+    if (argc - optind != 1) {
+        usage(stderr);
+        return 2;
+    }
+
+    MidiProcessor* processor = createConfiguredMidiProcessor(argv[optind], params, rulesPath);
+
+    if (processor == nullptr)
+        return 2;
+
+    MidiByteStreamProcessor* stream = new MidiByteStreamProcessor(*processor, STDOUT_FILENO);
+
+    // no SA_RESTART, so a blocking read() returns when we are interrupted
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = stopHandler;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    // report a closed output as a write error
+    std::signal(SIGPIPE, SIG_IGN);
+
+    while (ok && !sStop) {
+        const ssize_t count = read(STDIN_FILENO, buffer, sizeof(buffer));
+
+        if (count > 0) {
+            if (!stream->process(buffer, (size_t) count)) {
+                std::fprintf(stderr, "Error writing output: %s\n", std::strerror(errno));
+                ok = false;
+            }
+        }
+        else if (count == 0) {
+            break;
+        }
+        else if (errno != EINTR) {
+            std::fprintf(stderr, "Error reading input: %s\n", std::strerror(errno));
+            ok = false;
+        }
+    }
+
+    if (!quiet) {
+        std::fprintf(stderr, "%llu events in, %llu events out", (unsigned long long) stream->getEventsIn(),
+                     (unsigned long long) stream->getEventsOut());
+
+        if (stream->getDroppedCount() > 0)
+            std::fprintf(stderr, ", %llu dropped", (unsigned long long) stream->getDroppedCount());
+
+        std::fprintf(stderr, "\n");
+    }
+
+    delete stream;
+    delete processor;
+    return ok ? 0 : 1;
+}
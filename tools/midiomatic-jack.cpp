@@ -0,0 +1,430 @@
+/*
+ * Headless JACK client running a chain of midiomatic plugin cores
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <jack/jack.h>
+#include <jack/midiport.h>
+
+#include "MIDIProcessorChain.hpp"
+#include "MIDIUtils.hpp"
+
+USE_NAMESPACE_DISTRHO
+
+// -----------------------------------------------------------------------
+
+/**
+  Single-producer, single-consumer queue between the process callback and
+  the main thread. Both ends are wait-free, push() fails when it is full.
+*/
+template <class T, uint32_t kCapacity>
+class JackQueue {
+public:
+    JackQueue() noexcept
+        : fHead(0),
+          fTail(0) {}
+
+    bool push(const T& item) noexcept {
+        const uint32_t tail = fTail.load(std::memory_order_relaxed);
+
+        if (tail - fHead.load(std::memory_order_acquire) >= kCapacity)
+            return false;
+
+        fItems[tail % kCapacity] = item;
+        fTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) noexcept {
+        const uint32_t head = fHead.load(std::memory_order_relaxed);
+
+        if (head == fTail.load(std::memory_order_acquire))
+            return false;
+
+        item = fItems[head % kCapacity];
+        fHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T fItems[kCapacity];
+    std::atomic<uint32_t> fHead;
+    // consumer and producer index on separate cache lines
+    char fPadding[CACHE_LINE_SIZE];
+    std::atomic<uint32_t> fTail;
+};
+
+struct ParameterChange {
+    uint32_t stage;
+    uint32_t index;
+    float value;
+};
+
+/**
+  Counts of one reporting period, collected by the process callback.
+*/
+struct CycleStats {
+    uint64_t cycles;
+    uint64_t frames;
+    double loadSum;
+    double loadMax;
+    uint64_t eventsIn;
+    uint64_t eventsOut;
+    uint64_t eventsDropped;
+
+    void clear() noexcept {
+        cycles = frames = eventsIn = eventsOut = eventsDropped = 0;
+        loadSum = loadMax = 0.0;
+    }
+};
+
+struct JackRunner {
+    jack_client_t* client;
+    jack_port_t* inPort;
+    jack_port_t* outPort;
+    MidiProcessorChain chain;
+    JackQueue<ParameterChange, 64> changes;
+    JackQueue<CycleStats, 16> reports;
+    std::atomic<uint32_t> xruns;
+    // process callback only
+    CycleStats current;
+    uint32_t droppedBefore;
+    MidiEvent events[MidiEventBuffer::kCapacity];
+};
+
+static volatile sig_atomic_t sStop = 0;
+
+static void stopHandler(int) {
+    sStop = 1;
+}
+
+static inline uint64_t nowNanos() noexcept {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+// -----------------------------------------------------------------------
+// JACK callbacks
+
+static int jackProcess(jack_nframes_t nframes, void* arg) {
+    JackRunner* runner = (JackRunner*) arg;
+    const uint64_t start = nowNanos();
+    void* inBuffer = jack_port_get_buffer(runner->inPort, nframes);
+    void* outBuffer = jack_port_get_buffer(runner->outPort, nframes);
+    const uint32_t inCount = jack_midi_get_event_count(inBuffer);
+    const MidiEvent* output;
+    ParameterChange change;
+    jack_midi_event_t jev;
+    uint32_t count = 0;
+    uint32_t written = 0;
+
+    while (runner->changes.pop(change))
+        runner->chain.getStage(change.stage).setParameterValue(change.index, change.value);
+
+    for (uint32_t i=0; i < inCount && count < MidiEventBuffer::kCapacity; i++) {
+        if (jack_midi_event_get(&jev, inBuffer, i) != 0 || jev.size == 0)
+            continue;
+
+        MidiEvent& ev(runner->events[count++]);
+        ev.frame = jev.time;
+        ev.size = (uint32_t) jev.size;
+
+        if (jev.size > MidiEvent::kDataSize)
+            ev.dataExt = jev.buffer;
+        else
+            std::memcpy(ev.data, jev.buffer, jev.size);
+    }
+
+    const uint32_t outCount = runner->chain.process(runner->events, count, output);
+
+    jack_midi_clear_buffer(outBuffer);
+
+    for (uint32_t i=0; i < outCount; i++) {
+        const MidiEvent& ev(output[i]);
+        const uint8_t* data = ev.size > MidiEvent::kDataSize ? ev.dataExt : ev.data;
+
+        if (jack_midi_event_write(outBuffer, ev.frame, data, ev.size) == 0)
+            written++;
+    }
+
+    const uint32_t dropped = runner->chain.getDroppedCount();
+    const double load = (nowNanos() - start) * jack_get_sample_rate(runner->client) / (1e9 * nframes);
+    CycleStats& stats(runner->current);
+
+    stats.cycles++;
+    stats.frames += nframes;
+    stats.loadSum += load;
+    stats.eventsIn += inCount;
+    stats.eventsOut += written;
+    stats.eventsDropped += (inCount - count) + (outCount - written) + (dropped - runner->droppedBefore);
+    runner->droppedBefore = dropped;
+
+    if (load > stats.loadMax)
+        stats.loadMax = load;
+
+    // hand the counts to the main thread about once a second
+    if (stats.frames >= jack_get_sample_rate(runner->client) && runner->reports.push(stats))
+        stats.clear();
+
+    return 0;
+}
+
+static int jackXrun(void* arg) {
+    ((JackRunner*) arg)->xruns.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+}
+
+static void jackShutdown(void*) {
+    sStop = 1;
+}
+
+// -----------------------------------------------------------------------
+// Main thread
+
+/**
+  Handle a command line read from standard input: "STAGE SYMBOL VALUE" sets
+  a parameter of a stage, given by number or processor name.
+*/
+static void handleCommand(JackRunner& runner, char* line) {
+    char* saveptr;
+    const char* stageName = strtok_r(line, " \t\r\n", &saveptr);
+    const char* symbol = strtok_r(nullptr, " \t\r\n", &saveptr);
+    const char* valueText = strtok_r(nullptr, " \t\r\n", &saveptr);
+    ParameterChange change;
+    char* end;
+
+    if (stageName == nullptr)
+        return;
+
+    if (symbol == nullptr || valueText == nullptr) {
+        std::fprintf(stderr, "Expected: STAGE SYMBOL VALUE\n");
+        return;
+    }
+
+    const int32_t stage = runner.chain.findStage(stageName);
+
+    if (stage < 0) {
+        std::fprintf(stderr, "Unknown stage '%s'.\n", stageName);
+        return;
+    }
+
+    // looked up here, because initParameter() is not realtime-safe
+    const int32_t index = findMidiProcessorParameter(runner.chain.getStage(stage), symbol);
+    change.value = std::strtof(valueText, &end);
+
+    if (index < 0 || end == valueText || *end != '\0') {
+        std::fprintf(stderr, "Unknown parameter or invalid value: %s %s\n", symbol, valueText);
+        return;
+    }
+
+    change.stage = (uint32_t) stage;
+    change.index = (uint32_t) index;
+
+    if (!runner.changes.push(change))
+        std::fprintf(stderr, "Too many parameter changes, try again.\n");
+}
+
+static void printReport(const CycleStats& stats, uint32_t xruns) {
+    std::fprintf(stderr, "%llu cycles, DSP load avg %.2f%% max %.2f%%, %llu events in, %llu out",
+                 (unsigned long long) stats.cycles, 100.0 * stats.loadSum / (stats.cycles ? stats.cycles : 1),
+                 100.0 * stats.loadMax, (unsigned long long) stats.eventsIn, (unsigned long long) stats.eventsOut);
+
+    if (stats.eventsDropped > 0)
+        std::fprintf(stderr, ", %llu dropped", (unsigned long long) stats.eventsDropped);
+
+    if (xruns > 0)
+        std::fprintf(stderr, ", %u xruns", xruns);
+
+    std::fprintf(stderr, "\n");
+}
+
+static void usage(FILE* out) {
+    std::fprintf(out,
+        "Usage: midiomatic-jack [OPTIONS] CONFIG\n"
+        "\n"
+        "Run the chain of midiomatic MIDI processors listed in CONFIG as one JACK\n"
+        "client. Each line of CONFIG names a processor followed by parameter\n"
+        "assignments SYMBOL=VALUE, e.g. \"pbtocc cc1=2\". Lines \"STAGE SYMBOL VALUE\"\n"
+        "on standard input change parameters while running.\n"
+        "\n"
+        "Options:\n"
+        "  -n, --name NAME         JACK client name (default: midiomatic)\n"
+        "  -i, --input PORT        connect the MIDI input to PORT (repeatable)\n"
+        "  -o, --output PORT       connect the MIDI output to PORT (repeatable)\n"
+        "  -l, --list              list the processors and their parameters\n"
+        "  -q, --quiet             don't print statistics every second\n"
+        "  -h, --help              show this help\n");
+}
+
+int main(int argc, char** argv) {
+    static const struct option longOptions[] = {
+        {"name", required_argument, nullptr, 'n'},
+        {"input", required_argument, nullptr, 'i'},
+        {"output", required_argument, nullptr, 'o'},
+        {"list", no_argument, nullptr, 'l'},
+        {"quiet", no_argument, nullptr, 'q'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+    const char* clientName = "midiomatic";
+    std::vector<const char*> inputs, outputs;
+    struct sigaction action;
+    jack_status_t status;
+    std::string line;
+    bool quiet = false;
+    bool haveStdin = true;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "n:i:o:lqh", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 'n':
+                clientName = optarg;
+                break;
+            case 'i':
+                inputs.push_back(optarg);
+                break;
+            case 'o':
+                outputs.push_back(optarg);
+                break;
+            case 'l':
+                listMidiProcessors(stdout);
+                return 0;
+            case 'q':
+                quiet = true;
+                break;
+            case 'h':
+                usage(stdout);
+                return 0;
+            default:
+                usage(stderr);
+                return 2;
+        }
+    }
+
+    if (argc - optind != 1) {
+        usage(stderr);
+        return 2;
+    }
+
+    JackRunner* runner = new JackRunner();
+    runner->xruns = 0;
+    runner->current.clear();
+    runner->droppedBefore = 0;
+
+    if (!runner->chain.loadConfig(argv[optind])) {
+        delete runner;
+        return 2;
+    }
+
+    if ((runner->client = jack_client_open(clientName, JackNoStartServer, &status)) == nullptr) {
+        std::fprintf(stderr, "Could not connect to the JACK server.\n");
+        delete runner;
+        return 1;
+    }
+
+    runner->inPort = jack_port_register(runner->client, "midi_in", JACK_DEFAULT_MIDI_TYPE, JackPortIsInput, 0);
+    runner->outPort = jack_port_register(runner->client, "midi_out", JACK_DEFAULT_MIDI_TYPE, JackPortIsOutput, 0);
+
+    if (runner->inPort == nullptr || runner->outPort == nullptr) {
+        std::fprintf(stderr, "Could not register the JACK ports.\n");
+        jack_client_close(runner->client);
+        delete runner;
+        return 1;
+    }
+
+    jack_set_process_callback(runner->client, jackProcess, runner);
+    jack_set_xrun_callback(runner->client, jackXrun, runner);
+    jack_on_shutdown(runner->client, jackShutdown, runner);
+
+    // no SA_RESTART, so poll() returns when we are interrupted
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = stopHandler;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    if (jack_activate(runner->client) != 0) {
+        std::fprintf(stderr, "Could not activate the JACK client.\n");
+        jack_client_close(runner->client);
+        delete runner;
+        return 1;
+    }
+
+    for (size_t i=0; i < inputs.size(); i++) {
+        if (jack_connect(runner->client, inputs[i], jack_port_name(runner->inPort)) != 0)
+            std::fprintf(stderr, "Could not connect '%s' to the input.\n", inputs[i]);
+    }
+
+    for (size_t i=0; i < outputs.size(); i++) {
+        if (jack_connect(runner->client, jack_port_name(runner->outPort), outputs[i]) != 0)
+            std::fprintf(stderr, "Could not connect the output to '%s'.\n", outputs[i]);
+    }
+
+    std::fprintf(stderr, "Running %u stages as JACK client '%s'.\n", runner->chain.getStageCount(),
+                 jack_get_client_name(runner->client));
+
+    while (!sStop) {
+        struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+        CycleStats stats;
+        char buffer[256];
+
+        if (poll(&pfd, haveStdin ? 1 : 0, 100) > 0) {
+            const ssize_t count = read(STDIN_FILENO, buffer, sizeof(buffer));
+
+            if (count > 0)
+                line.append(buffer, (size_t) count);
+            else
+                haveStdin = false;
+
+            for (size_t pos; (pos = line.find('\n')) != std::string::npos; line.erase(0, pos + 1)) {
+                std::vector<char> command(line.begin(), line.begin() + pos);
+                command.push_back('\0');
+                handleCommand(*runner, command.data());
+            }
+        }
+
+        while (runner->reports.pop(stats)) {
+            if (!quiet)
+                printReport(stats, runner->xruns.exchange(0, std::memory_order_relaxed));
+        }
+    }
+
+    jack_deactivate(runner->client);
+    jack_client_close(runner->client);
+    delete runner;
+    return 0;
+}
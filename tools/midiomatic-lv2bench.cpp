@@ -0,0 +1,587 @@
+/*
+ * LV2 load benchmark for the separate and the combined midiomatic bundles
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+
+/*
+  Measures what loading the midiomatic LV2 plugins costs a host, once for the
+  eight separate bundles and once for the combined bundle built with
+  "make combined":
+
+  - scan: dlopen() of each plugin library and enumeration of its plugins with
+    lv2_descriptor(), which is what a host does for every bundle on startup;
+  - startup: the scan plus instantiate() and activate() of every plugin, which
+    is what a host does when it loads a session with all plugins in it;
+  - RSS: the resident memory the libraries and the instances add;
+  - heap: the memory allocated with malloc() / new while loading the
+    libraries (e.g. by static initializers) and per plugin instance.
+
+  Every run happens in a fresh child process, so the libraries are never
+  already loaded and the measurements of one set don't affect the other.
+  The RSS is read from /proc/self/statm and the heap use from mallinfo2(),
+  so these figures need Linux and glibc.
+
+  Only the parts of the LV2 ABI used here are declared below.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <dlfcn.h>
+#include <malloc.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// -----------------------------------------------------------------------
+// LV2 ABI
+
+struct LV2_Feature {
+    const char* URI;
+    void* data;
+};
+
+typedef void* LV2_Handle;
+
+struct LV2_Descriptor {
+    const char* URI;
+    LV2_Handle (*instantiate)(const LV2_Descriptor*, double, const char*, const LV2_Feature* const*);
+    void (*connect_port)(LV2_Handle, uint32_t, void*);
+    void (*activate)(LV2_Handle);
+    void (*run)(LV2_Handle, uint32_t);
+    void (*deactivate)(LV2_Handle);
+    void (*cleanup)(LV2_Handle);
+    const void* (*extension_data)(const char*);
+};
+
+typedef const LV2_Descriptor* (*LV2_Descriptor_Function)(uint32_t);
+
+typedef uint32_t LV2_URID;
+typedef void* LV2_URID_Map_Handle;
+
+struct LV2_URID_Map {
+    LV2_URID_Map_Handle handle;
+    LV2_URID (*map)(LV2_URID_Map_Handle, const char*);
+};
+
+struct LV2_Options_Option {
+    uint32_t context;
+    uint32_t subject;
+    LV2_URID key;
+    uint32_t size;
+    LV2_URID type;
+    const void* value;
+};
+
+static const char* const kLv2UridMap = "http://lv2plug.in/ns/ext/urid#map";
+static const char* const kLv2Options = "http://lv2plug.in/ns/ext/options#options";
+static const char* const kLv2AtomInt = "http://lv2plug.in/ns/ext/atom#Int";
+static const char* const kLv2AtomFloat = "http://lv2plug.in/ns/ext/atom#Float";
+static const char* const kLv2NominalBlockLength = "http://lv2plug.in/ns/ext/buf-size#nominalBlockLength";
+static const char* const kLv2MaxBlockLength = "http://lv2plug.in/ns/ext/buf-size#maxBlockLength";
+static const char* const kLv2SampleRate = "http://lv2plug.in/ns/ext/parameters#sampleRate";
+
+// -----------------------------------------------------------------------
+// Host
+
+static const double kSampleRate = 48000.0;
+static const int32_t kBlockLength = 512;
+static const float kSampleRateValue = (float) kSampleRate;
+
+/**
+  The URID map of the host. Lookups are linear, which is fine for the few
+  URIs the plugins map when they are instantiated.
+*/
+static std::vector<std::string> sUris;
+
+static LV2_URID mapUri(LV2_URID_Map_Handle, const char* uri) {
+    for (size_t i=0; i < sUris.size(); i++) {
+        if (sUris[i] == uri)
+            return (LV2_URID) (i + 1);
+    }
+
+    sUris.push_back(uri);
+    return (LV2_URID) sUris.size();
+}
+
+/**
+  The features the DPF LV2 wrapper requires: a URID map and the options with
+  the block length and sample rate.
+*/
+struct BenchHost {
+    LV2_URID_Map uridMap;
+    LV2_Options_Option options[4];
+    LV2_Feature uridMapFeature;
+    LV2_Feature optionsFeature;
+    const LV2_Feature* features[3];
+
+    BenchHost() {
+        uridMap.handle = nullptr;
+        uridMap.map = mapUri;
+
+        const LV2_URID atomInt = mapUri(nullptr, kLv2AtomInt);
+
+        std::memset(options, 0, sizeof(options));
+        options[0].key = mapUri(nullptr, kLv2NominalBlockLength);
+        options[0].size = sizeof(int32_t);
+        options[0].type = atomInt;
+        options[0].value = &kBlockLength;
+        options[1].key = mapUri(nullptr, kLv2MaxBlockLength);
+        options[1].size = sizeof(int32_t);
+        options[1].type = atomInt;
+        options[1].value = &kBlockLength;
+        options[2].key = mapUri(nullptr, kLv2SampleRate);
+        options[2].size = sizeof(float);
+        options[2].type = mapUri(nullptr, kLv2AtomFloat);
+        options[2].value = &kSampleRateValue;
+
+        uridMapFeature.URI = kLv2UridMap;
+        uridMapFeature.data = &uridMap;
+        optionsFeature.URI = kLv2Options;
+        optionsFeature.data = options;
+        features[0] = &uridMapFeature;
+        features[1] = &optionsFeature;
+        features[2] = nullptr;
+    }
+};
+
+// -----------------------------------------------------------------------
+// Measurement
+
+static double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+  Resident set size of this process in bytes.
+*/
+static int64_t residentBytes() {
+    unsigned long size = 0, resident = 0;
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+
+    if (statm == nullptr)
+        return 0;
+
+    if (std::fscanf(statm, "%lu %lu", &size, &resident) != 2)
+        resident = 0;
+
+    std::fclose(statm);
+    return (int64_t) resident * (int64_t) sysconf(_SC_PAGESIZE);
+}
+
+/**
+  Bytes currently allocated on the heap of this process, including large
+  blocks, which malloc() maps separately.
+*/
+static int64_t heapBytes() {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    const struct mallinfo2 info = mallinfo2();
+    return (int64_t) (info.uordblks + info.hblkhd);
+#elif defined(__GLIBC__)
+    const struct mallinfo info = mallinfo();
+    return (int64_t) (uint32_t) info.uordblks + (int64_t) (uint32_t) info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+static bool endsWith(const std::string& str, const char* suffix) {
+    const size_t len = std::strlen(suffix);
+    return str.size() >= len && str.compare(str.size() - len, len, suffix) == 0;
+}
+
+static bool isDirectory(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static std::vector<std::string> listDirectory(const std::string& path) {
+    std::vector<std::string> names;
+    DIR* dir = opendir(path.c_str());
+
+    if (dir == nullptr)
+        return names;
+
+    while (const struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.')
+            names.push_back(entry->d_name);
+    }
+
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+/**
+  A plugin library and the bundle it is in.
+*/
+struct BenchLibrary {
+    std::string bundle;
+    std::string path;
+};
+
+/**
+  Add the plugin libraries in the bundle at @a bundle, i.e. all shared objects
+  but the UIs, to @a libraries.
+*/
+static void addBundle(const std::string& bundle, std::vector<BenchLibrary>& libraries) {
+    const std::vector<std::string> names = listDirectory(bundle);
+
+    for (size_t i=0; i < names.size(); i++) {
+        if (endsWith(names[i], ".so") && ! endsWith(names[i], "_ui.so")) {
+            BenchLibrary library;
+            library.bundle = bundle + "/";
+            library.path = bundle + "/" + names[i];
+            libraries.push_back(library);
+        }
+    }
+}
+
+/**
+  The plugin libraries of a set, given as a bundle or as a directory with
+  bundles in it, like "bin" for the separate bundles or "bin/combined".
+*/
+static std::vector<BenchLibrary> findLibraries(const std::string& path) {
+    std::vector<BenchLibrary> libraries;
+
+    if (endsWith(path, ".lv2")) {
+        addBundle(path, libraries);
+        return libraries;
+    }
+
+    const std::vector<std::string> names = listDirectory(path);
+
+    for (size_t i=0; i < names.size(); i++) {
+        if (endsWith(names[i], ".lv2") && isDirectory(path + "/" + names[i]))
+            addBundle(path + "/" + names[i], libraries);
+    }
+
+    return libraries;
+}
+
+struct LoadResult {
+    bool ok;
+    uint32_t plugins;
+    uint32_t instances;
+    double scanSeconds;
+    double startupSeconds;
+    int64_t scanBytes;
+    int64_t instanceBytes;
+    int64_t scanHeapBytes;
+    int64_t instanceHeapBytes;
+};
+
+/**
+  Load, scan and instantiate all plugins in @a libraries once. Meant to be run
+  in a fresh process.
+*/
+static LoadResult loadPlugins(const std::vector<BenchLibrary>& libraries) {
+    struct Instance {
+        const LV2_Descriptor* descriptor;
+        LV2_Handle handle;
+    };
+
+    LoadResult result;
+    std::memset(&result, 0, sizeof(result));
+    result.ok = true;
+
+    BenchHost host;
+    std::vector<void*> handles;
+    std::vector<const LV2_Descriptor*> descriptors;
+    std::vector<const char*> bundles;
+    std::vector<Instance> instances;
+
+    handles.reserve(libraries.size());
+    descriptors.reserve(64);
+    bundles.reserve(64);
+    instances.reserve(64);
+
+    const int64_t startBytes = residentBytes();
+    const int64_t startHeap = heapBytes();
+    const double start = now();
+
+    for (size_t i=0; i < libraries.size(); i++) {
+        void* lib = dlopen(libraries[i].path.c_str(), RTLD_NOW | RTLD_LOCAL);
+
+        if (lib == nullptr) {
+            std::fprintf(stderr, "%s\n", dlerror());
+            result.ok = false;
+            continue;
+        }
+
+        handles.push_back(lib);
+
+        LV2_Descriptor_Function descriptorFunc = (LV2_Descriptor_Function) dlsym(lib, "lv2_descriptor");
+
+        if (descriptorFunc == nullptr) {
+            std::fprintf(stderr, "%s: not an LV2 plugin\n", libraries[i].path.c_str());
+            result.ok = false;
+            continue;
+        }
+
+        for (uint32_t index=0; const LV2_Descriptor* descriptor = descriptorFunc(index); index++) {
+            descriptors.push_back(descriptor);
+            bundles.push_back(libraries[i].bundle.c_str());
+        }
+    }
+
+    const double scanned = now();
+    const int64_t scannedBytes = residentBytes();
+    const int64_t scannedHeap = heapBytes();
+
+    for (size_t i=0; i < descriptors.size(); i++) {
+        Instance instance;
+        instance.descriptor = descriptors[i];
+        instance.handle = descriptors[i]->instantiate(descriptors[i], kSampleRate, bundles[i], host.features);
+
+        if (instance.handle == nullptr) {
+            std::fprintf(stderr, "%s: could not create the plugin instance\n", descriptors[i]->URI);
+            result.ok = false;
+            continue;
+        }
+
+        if (instance.descriptor->activate != nullptr)
+            instance.descriptor->activate(instance.handle);
+
+        instances.push_back(instance);
+    }
+
+    const double started = now();
+    const int64_t startedBytes = residentBytes();
+    const int64_t startedHeap = heapBytes();
+
+    result.plugins = (uint32_t) descriptors.size();
+    result.instances = (uint32_t) instances.size();
+    result.scanSeconds = scanned - start;
+    result.startupSeconds = started - start;
+    result.scanBytes = scannedBytes - startBytes;
+    result.instanceBytes = startedBytes - scannedBytes;
+    result.scanHeapBytes = scannedHeap - startHeap;
+    result.instanceHeapBytes = startedHeap - scannedHeap;
+
+    for (size_t i=0; i < instances.size(); i++) {
+        if (instances[i].descriptor->deactivate != nullptr)
+            instances[i].descriptor->deactivate(instances[i].handle);
+
+        instances[i].descriptor->cleanup(instances[i].handle);
+    }
+
+    for (size_t i=0; i < handles.size(); i++)
+        dlclose(handles[i]);
+
+    return result;
+}
+
+/**
+  Run loadPlugins() in a child process and pass its result back through a
+  pipe. Returns false if the child failed.
+*/
+static bool loadPluginsInChild(const std::vector<BenchLibrary>& libraries, LoadResult& result) {
+    int fds[2];
+
+    if (pipe(fds) != 0) {
+        std::perror("pipe");
+        return false;
+    }
+
+    std::fflush(stdout);
+    std::fflush(stderr);
+
+    const pid_t pid = fork();
+
+    if (pid < 0) {
+        std::perror("fork");
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        const LoadResult childResult = loadPlugins(libraries);
+        const bool written = write(fds[1], &childResult, sizeof(childResult)) == (ssize_t) sizeof(childResult);
+        std::fflush(stderr);
+        _exit(written && childResult.ok ? 0 : 1);
+    }
+
+    close(fds[1]);
+    const bool received = read(fds[0], &result, sizeof(result)) == (ssize_t) sizeof(result);
+    close(fds[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return received && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// -----------------------------------------------------------------------
+
+struct SetResult {
+    std::string name;
+    uint32_t libraries;
+    uint32_t plugins;
+    uint32_t instances;
+    double scanSeconds;
+    double startupSeconds;
+    int64_t scanBytes;
+    int64_t instanceBytes;
+    int64_t scanHeapBytes;
+    int64_t instanceHeapBytes;
+};
+
+/**
+  Measure the set at @a path @a repeat times and keep the fastest times. The
+  memory figures are those of the last run.
+*/
+static bool benchSet(const std::string& path, uint32_t repeat, SetResult& set) {
+    const std::vector<BenchLibrary> libraries = findLibraries(path);
+
+    if (libraries.empty()) {
+        std::fprintf(stderr, "%s: no LV2 plugin libraries found\n", path.c_str());
+        return false;
+    }
+
+    set.name = path;
+    set.libraries = (uint32_t) libraries.size();
+    set.scanSeconds = 1e30;
+    set.startupSeconds = 1e30;
+
+    for (uint32_t r=0; r < repeat; r++) {
+        LoadResult result;
+
+        if (! loadPluginsInChild(libraries, result)) {
+            std::fprintf(stderr, "%s: loading the plugins failed\n", path.c_str());
+            return false;
+        }
+
+        set.plugins = result.plugins;
+        set.instances = result.instances;
+        set.scanSeconds = std::min(set.scanSeconds, result.scanSeconds);
+        set.startupSeconds = std::min(set.startupSeconds, result.startupSeconds);
+        set.scanBytes = result.scanBytes;
+        set.instanceBytes = result.instanceBytes;
+        set.scanHeapBytes = result.scanHeapBytes;
+        set.instanceHeapBytes = result.instanceHeapBytes;
+    }
+
+    return true;
+}
+
+static void usage(FILE* out) {
+    std::fprintf(out,
+        "Usage: midiomatic-lv2bench [OPTIONS] [SET...]\n"
+        "\n"
+        "Measure the time to scan the LV2 plugins of each SET (dlopen() and\n"
+        "lv2_descriptor()), the startup time (the scan plus instantiating and\n"
+        "activating every plugin), the resident memory both add and the heap\n"
+        "memory allocated by loading the libraries and per plugin instance. A SET\n"
+        "is an LV2 bundle or a directory with bundles in it. Each run is done in a\n"
+        "fresh process and the fastest of all runs is reported.\n"
+        "\n"
+        "The default sets are 'bin' (the separate bundles) and 'bin/combined' (the\n"
+        "bundle built with 'make combined'). Sets after the first are also compared\n"
+        "to the first.\n"
+        "\n"
+        "Options:\n"
+        "  -r, --repeat N  runs per set (default: 20)\n"
+        "  -h, --help      show this help\n");
+}
+
+int main(int argc, char** argv) {
+    static const struct option longOptions[] = {
+        {"repeat", required_argument, nullptr, 'r'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+    uint32_t repeat = 20;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "r:h", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 'r':
+                repeat = (uint32_t) std::atoi(optarg);
+                break;
+            case 'h':
+                usage(stdout);
+                return 0;
+            default:
+                usage(stderr);
+                return 2;
+        }
+    }
+
+    if (repeat == 0) {
+        usage(stderr);
+        return 2;
+    }
+
+    std::vector<std::string> paths(argv + optind, argv + argc);
+
+    if (paths.empty()) {
+        paths.push_back("bin");
+        paths.push_back("bin/combined");
+    }
+
+    std::vector<SetResult> sets;
+
+    for (size_t i=0; i < paths.size(); i++) {
+        SetResult set;
+
+        if (! benchSet(paths[i], repeat, set))
+            return 1;
+
+        sets.push_back(set);
+    }
+
+    std::printf("%-24s %5s %7s %9s %11s %12s %12s %13s %11s\n", "set", "libs", "plugins", "scan ms",
+                "startup ms", "scan RSS KiB", "inst RSS KiB", "scan heap KiB", "heap/inst B");
+
+    for (size_t i=0; i < sets.size(); i++) {
+        std::printf("%-24s %5u %7u %9.3f %11.3f %12lld %12lld %13lld %11lld\n", sets[i].name.c_str(),
+                    sets[i].libraries, sets[i].plugins, sets[i].scanSeconds * 1e3,
+                    sets[i].startupSeconds * 1e3, (long long) (sets[i].scanBytes / 1024),
+                    (long long) (sets[i].instanceBytes / 1024), (long long) (sets[i].scanHeapBytes / 1024),
+                    (long long) (sets[i].instances > 0 ? sets[i].instanceHeapBytes / sets[i].instances : 0));
+    }
+
+    for (size_t i=1; i < sets.size(); i++) {
+        std::printf("%s vs %s: scan %.2fx, startup %.2fx, RSS %+lld KiB, heap %+lld KiB\n",
+                    sets[i].name.c_str(), sets[0].name.c_str(), sets[i].scanSeconds / sets[0].scanSeconds,
+                    sets[i].startupSeconds / sets[0].startupSeconds,
+                    (long long) ((sets[i].scanBytes + sets[i].instanceBytes)
+                                 - (sets[0].scanBytes + sets[0].instanceBytes)) / 1024,
+                    (long long) ((sets[i].scanHeapBytes + sets[i].instanceHeapBytes)
+                                 - (sets[0].scanHeapBytes + sets[0].instanceHeapBytes)) / 1024);
+    }
+
+    return 0;
+}
@@ -0,0 +1,558 @@
+/*
+ * Multi-instance, multi-thread benchmark of the midiomatic VST2 plugins
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+
+/*
+  A VST2 host, which runs many instances of each given plugin from a pool of
+  worker threads, like a host with a multi-threaded processing graph. Every
+  instance gets the same MIDI events, transport changes and parameter
+  changes, so all of them must send the same output as one instance run
+  alone. Otherwise they share mutable state, e.g. a function-static variable
+  in run() or a global table written by one of them.
+
+  Unlike the "scaling" mode of midiomatic-bench, this drives the complete
+  plugins built by DPF, including the MidiProcessorPlugin wrapper, MIDI CC
+  Recorder, MIDI Chain and MIDI Rules, which have state outside of their
+  MIDI processor cores.
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <dlfcn.h>
+
+#include "MIDIVstHost.hpp"
+
+// -----------------------------------------------------------------------
+// Schedule
+
+static constexpr uint32_t kBlockSize = 256;
+static constexpr uint32_t kMaxBlockEvents = 32;
+static constexpr uint32_t kMaxChannels = 8;
+static constexpr double kSampleRate = 48000.0;
+static const float parameterValues[] = {0.0f, 0.25f, 0.5f, 0.75f, 1.0f};
+
+/**
+  The input of one block, the same for every instance: MIDI events, the
+  transport position and, in every fourth block, a parameter change.
+*/
+struct PlugBenchBlock {
+    VstMidiEvent midiEvents[kMaxBlockEvents];
+    VstEventList<kMaxBlockEvents> eventList;
+    VstTimeInfo timeInfo;
+    // parameter index modulo the plugin's parameter count, or -1
+    int32_t parameter;
+    float value;
+};
+
+class PlugBenchSchedule {
+public:
+    explicit PlugBenchSchedule(uint32_t numBlocks)
+        : fBlocks(numBlocks),
+          fRandom(1) {
+        std::memset(&fBlocks[0], 0, sizeof(PlugBenchBlock) * numBlocks);
+
+        VstTimeInfo timeInfo;
+        std::memset(&timeInfo, 0, sizeof(timeInfo));
+
+        for (uint32_t b=0; b < numBlocks; b++) {
+            PlugBenchBlock& block(fBlocks[b]);
+
+            fillEvents(block, b % 8 == 7 ? kMaxBlockEvents : next() % 12);
+            advanceTransport(timeInfo);
+            block.timeInfo = timeInfo;
+            block.parameter = b % 4 == 3 ? (int32_t) (next() % 1024) : -1;
+            block.value = parameterValues[next() % (sizeof(parameterValues) / sizeof(parameterValues[0]))];
+        }
+    }
+
+    uint32_t size() const noexcept {
+        return (uint32_t) fBlocks.size();
+    }
+
+    const PlugBenchBlock& operator[](uint32_t index) const noexcept {
+        return fBlocks[index];
+    }
+
+private:
+    uint32_t next() noexcept {
+        fRandom ^= fRandom << 13;
+        fRandom ^= fRandom >> 17;
+        fRandom ^= fRandom << 5;
+        return fRandom;
+    }
+
+    void fillEvents(PlugBenchBlock& block, uint32_t count) noexcept;
+    void advanceTransport(VstTimeInfo& timeInfo) noexcept;
+
+    std::vector<PlugBenchBlock> fBlocks;
+    uint32_t fRandom;
+};
+
+/**
+  Fill the event list of @a block with @a count events of all channel message
+  types, mostly Control Changes, which MIDI CC Recorder records and replays,
+  on random channels and with ascending frame offsets.
+*/
+void PlugBenchSchedule::fillEvents(PlugBenchBlock& block, uint32_t count) noexcept {
+    static const uint8_t statusTypes[] = {0x80, 0x90, 0xA0, 0xB0, 0xB0, 0xB0, 0xB0, 0xC0, 0xD0, 0xE0, 0xF8};
+    uint32_t frame = 0;
+
+    for (uint32_t i=0; i < count; i++) {
+        VstMidiEvent& event(block.midiEvents[i]);
+        uint8_t status = statusTypes[next() % sizeof(statusTypes)];
+
+        if (status < 0xF0)
+            status |= next() % 4;
+
+        frame += next() % (kBlockSize / count + 1);
+
+        event.type = kVstMidiType;
+        event.byteSize = sizeof(VstMidiEvent);
+        event.deltaFrames = (int32_t) (frame < kBlockSize ? frame : kBlockSize - 1);
+        event.midiData[0] = (char) status;
+        event.midiData[1] = status < 0xF0 ? (char) (next() % 128) : 0;
+        event.midiData[2] = status < 0xF0 && (status & 0xF0) != 0xC0 && (status & 0xF0) != 0xD0
+            ? (char) (next() % 128) : 0;
+        block.eventList.events[i] = &event;
+    }
+
+    block.eventList.numEvents = (int32_t) count;
+}
+
+/**
+  Move the transport on by one block. It starts, stops and jumps back to the
+  start now and then, which triggers MIDI CC Recorder's replay.
+*/
+void PlugBenchSchedule::advanceTransport(VstTimeInfo& timeInfo) noexcept {
+    const uint32_t change = next() % 32;
+    const bool playing = (timeInfo.flags & kVstTransportPlaying) != 0;
+
+    timeInfo.flags = kVstPpqPosValid | kVstTempoValid | kVstBarsValid | kVstTimeSigValid
+        | (playing ? kVstTransportPlaying : 0);
+
+    if (change == 0) {
+        timeInfo.flags ^= kVstTransportPlaying | kVstTransportChanged;
+    } else if (change == 1) {
+        timeInfo.samplePos = 0.0;
+        timeInfo.flags |= kVstTransportChanged;
+    } else if (playing) {
+        timeInfo.samplePos += kBlockSize;
+    }
+
+    timeInfo.sampleRate = kSampleRate;
+    timeInfo.tempo = 120.0;
+    timeInfo.ppqPos = timeInfo.samplePos / kSampleRate * timeInfo.tempo / 60.0;
+    timeInfo.barStartPos = (double) ((uint64_t) timeInfo.ppqPos / 4 * 4);
+    timeInfo.timeSigNumerator = 4;
+    timeInfo.timeSigDenominator = 4;
+}
+
+// -----------------------------------------------------------------------
+// Instances
+
+/**
+  One plugin instance and what the host keeps for it. Only the worker thread
+  it is assigned to touches it while running. The instance is found from the
+  AEffect in the host callback through AEffect::user.
+*/
+struct PlugBenchInstance {
+    AEffect* effect;
+    const VstTimeInfo* timeInfo;
+    bool processing;
+    uint64_t checksum;
+    uint64_t eventsOut;
+    float buffers[kMaxChannels][kBlockSize];
+    float* channels[kMaxChannels];
+    // keep the data written by different threads on different cache lines
+    char padding[64];
+
+    PlugBenchInstance() noexcept
+        : effect(nullptr),
+          timeInfo(nullptr),
+          processing(false),
+          checksum(0xCBF29CE484222325ULL),
+          eventsOut(0) {
+        std::memset(buffers, 0, sizeof(buffers));
+
+        for (uint32_t i=0; i < kMaxChannels; i++)
+            channels[i] = buffers[i];
+    }
+
+    /**
+      Fold an output event into the checksum (FNV-1a).
+    */
+    void addOutput(const VstMidiEvent& event) noexcept {
+        const uint8_t bytes[] = {
+            (uint8_t) event.type, (uint8_t) event.deltaFrames, (uint8_t) (event.deltaFrames >> 8),
+            (uint8_t) event.midiData[0], (uint8_t) event.midiData[1], (uint8_t) event.midiData[2]
+        };
+        const uint32_t size = event.type == kVstMidiType ? sizeof(bytes) : 3;
+
+        for (uint32_t i=0; i < size; i++) {
+            checksum ^= bytes[i];
+            checksum *= 0x100000001B3ULL;
+        }
+
+        eventsOut++;
+    }
+};
+
+static intptr_t hostCallback(AEffect* effect, int32_t opcode, int32_t, intptr_t, void* ptr, float) {
+    static VstTimeInfo noTimeInfo;
+    PlugBenchInstance* instance = effect != nullptr ? (PlugBenchInstance*) effect->user : nullptr;
+
+    switch (opcode) {
+        case audioMasterVersion:
+            return 2400;
+        case audioMasterGetTime:
+            return (intptr_t) (instance != nullptr && instance->timeInfo != nullptr ? instance->timeInfo
+                               : &noTimeInfo);
+        case audioMasterProcessEvents:
+            if (instance != nullptr && ptr != nullptr) {
+                const VstEventList<1>* events = (const VstEventList<1>*) ptr;
+
+                for (int32_t i=0; i < events->numEvents; i++)
+                    instance->addOutput(*events->events[i]);
+            }
+            return 1;
+        case audioMasterGetSampleRate:
+            return (intptr_t) kSampleRate;
+        case audioMasterGetBlockSize:
+            return kBlockSize;
+        case audioMasterGetCurrentProcessLevel:
+            return instance != nullptr && instance->processing ? 2 : 1;
+        case audioMasterCanDo:
+            return vstHostCanDo((const char*) ptr);
+        default:
+            return 0;
+    }
+}
+
+/**
+  Create an instance of the plugin in @a lib and start processing. Plugins
+  with states, MIDI Rules and MIDI CC Recorder, get the state chunk of
+  midiomatic-rtcheck, so they have rules and recorded values.
+*/
+static bool startInstance(const char* path, void*& lib, PlugBenchInstance& instance) {
+    AEffect* effect = loadVstPlugin(path, hostCallback, lib);
+
+    if (effect == nullptr)
+        return false;
+
+    if (effect->numInputs > (int32_t) kMaxChannels || effect->numOutputs > (int32_t) kMaxChannels) {
+        std::fprintf(stderr, "%s: too many audio channels\n", path);
+        effect->dispatcher(effect, effClose, 0, 0, nullptr, 0.0f);
+        return false;
+    }
+
+    instance.effect = effect;
+    effect->user = &instance;
+
+    effect->dispatcher(effect, effOpen, 0, 0, nullptr, 0.0f);
+    effect->dispatcher(effect, effSetSampleRate, 0, 0, nullptr, (float) kSampleRate);
+    effect->dispatcher(effect, effSetBlockSize, 0, kBlockSize, nullptr, 0.0f);
+
+    if (effect->flags & kEffFlagsProgramChunks) {
+        std::string chunk = makeStateChunk(0);
+        effect->dispatcher(effect, effSetChunk, 0, (intptr_t) chunk.size(), &chunk[0], 0.0f);
+    }
+
+    effect->dispatcher(effect, effMainsChanged, 0, 1, nullptr, 0.0f);
+    effect->dispatcher(effect, effStartProcess, 0, 0, nullptr, 0.0f);
+    return true;
+}
+
+static void stopInstance(PlugBenchInstance& instance) {
+    AEffect* effect = instance.effect;
+
+    if (effect == nullptr)
+        return;
+
+    effect->dispatcher(effect, effStopProcess, 0, 0, nullptr, 0.0f);
+    effect->dispatcher(effect, effMainsChanged, 0, 0, nullptr, 0.0f);
+    effect->dispatcher(effect, effClose, 0, 0, nullptr, 0.0f);
+    instance.effect = nullptr;
+}
+
+static void processBlock(PlugBenchInstance& instance, const PlugBenchBlock& block) {
+    AEffect* effect = instance.effect;
+
+    instance.timeInfo = &block.timeInfo;
+
+    if (block.parameter >= 0 && effect->numParams > 0)
+        effect->setParameter(effect, block.parameter % effect->numParams, block.value);
+
+    instance.processing = true;
+
+    if (block.eventList.numEvents > 0)
+        effect->dispatcher(effect, effProcessEvents, 0, 0, (void*) &block.eventList, 0.0f);
+
+    effect->processReplacing(effect, instance.channels, instance.channels, (int32_t) kBlockSize);
+    instance.processing = false;
+}
+
+// -----------------------------------------------------------------------
+// Benchmark
+
+static double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct PlugBenchResult {
+    bool ok;
+    double eventsPerSecond;
+    double latencyMedian;
+    double latency99;
+    double latencyMax;
+    uint32_t mismatches;
+};
+
+/**
+  Run @a numInstances instances of the plugin at @a path with @a numThreads
+  worker threads, which each process every @a numThreads-th instance block
+  by block. The output of every instance is compared with @a reference.
+*/
+static PlugBenchResult runInstances(const char* path, void*& lib, const PlugBenchSchedule& schedule,
+                                    uint64_t reference, uint32_t numInstances, uint32_t numThreads) {
+    std::vector<PlugBenchInstance*> instances(numInstances);
+    std::vector<std::vector<float> > latencies(numThreads);
+    std::vector<std::thread> threads;
+    PlugBenchResult result;
+    uint64_t eventsIn = 0;
+
+    std::memset(&result, 0, sizeof(result));
+    result.ok = true;
+
+    for (uint32_t i=0; i < numInstances; i++) {
+        instances[i] = new PlugBenchInstance();
+        result.ok = startInstance(path, lib, *instances[i]) && result.ok;
+    }
+
+    for (uint32_t b=0; b < schedule.size(); b++)
+        eventsIn += (uint32_t) schedule[b].eventList.numEvents;
+
+    if (result.ok) {
+        auto worker = [&](uint32_t first) {
+            std::vector<float>& workerLatencies(latencies[first]);
+
+            workerLatencies.reserve(schedule.size() * (numInstances / numThreads + 1));
+
+            for (uint32_t b=0; b < schedule.size(); b++) {
+                for (uint32_t i=first; i < numInstances; i += numThreads) {
+                    const double start = now();
+                    processBlock(*instances[i], schedule[b]);
+                    workerLatencies.push_back((float) (1e9 * (now() - start)));
+                }
+            }
+        };
+
+        const double start = now();
+
+        for (uint32_t t=1; t < numThreads; t++)
+            threads.push_back(std::thread(worker, t));
+
+        worker(0);
+
+        for (size_t t=0; t < threads.size(); t++)
+            threads[t].join();
+
+        const double seconds = now() - start;
+        std::vector<float> all;
+
+        for (uint32_t t=0; t < numThreads; t++)
+            all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+
+        std::sort(all.begin(), all.end());
+
+        result.eventsPerSecond = (double) eventsIn * numInstances / seconds;
+        result.latencyMedian = all[all.size() / 2];
+        result.latency99 = all[all.size() * 99 / 100];
+        result.latencyMax = all.back();
+    }
+
+    for (uint32_t i=0; i < numInstances; i++) {
+        if (result.ok && instances[i]->checksum != reference)
+            result.mismatches++;
+
+        stopInstance(*instances[i]);
+        delete instances[i];
+    }
+
+    return result;
+}
+
+/**
+  Benchmark the plugin at @a path with 1, 2, 4, ... threads. Returns false if
+  it could not be loaded or if any instance sent other output than an
+  instance run alone.
+*/
+static bool benchPlugin(const char* path, const PlugBenchSchedule& schedule, uint32_t numInstances,
+                        uint32_t maxThreads, uint32_t repeat) {
+    void* lib = nullptr;
+    PlugBenchInstance single;
+    bool ok = true;
+
+    if (! startInstance(path, lib, single)) {
+        if (lib != nullptr)
+            dlclose(lib);
+        return false;
+    }
+
+    for (uint32_t b=0; b < schedule.size(); b++)
+        processBlock(single, schedule[b]);
+
+    stopInstance(single);
+    std::printf("%s: %llu events out per instance\n", path, (unsigned long long) single.eventsOut);
+
+    double base = 0.0;
+
+    for (uint32_t threads=1; threads <= maxThreads; threads *= 2) {
+        PlugBenchResult best;
+        uint32_t mismatches = 0;
+
+        std::memset(&best, 0, sizeof(best));
+
+        for (uint32_t r=0; r < repeat; r++) {
+            const PlugBenchResult result = runInstances(path, lib, schedule, single.checksum, numInstances,
+                                                        threads);
+
+            if (! result.ok) {
+                dlclose(lib);
+                return false;
+            }
+
+            if (r == 0 || result.eventsPerSecond > best.eventsPerSecond)
+                best = result;
+
+            mismatches = std::max(mismatches, result.mismatches);
+        }
+
+        if (threads == 1)
+            base = best.eventsPerSecond;
+
+        std::printf("  %7u %12.3f %8.2f %10.0f %10.0f %10.0f  ", threads, best.eventsPerSecond / 1e6,
+                    best.eventsPerSecond / base, best.latencyMedian, best.latency99, best.latencyMax);
+
+        if (mismatches > 0) {
+            std::printf("%u INSTANCES DIFFER (SHARED STATE)\n", mismatches);
+            ok = false;
+        }
+        else {
+            std::printf("ok\n");
+        }
+    }
+
+    dlclose(lib);
+    return ok;
+}
+
+static void usage(FILE* out) {
+    std::fprintf(out,
+        "Usage: midiomatic-plugbench [OPTIONS] PLUGIN.so...\n"
+        "\n"
+        "Run many instances of each VST2 plugin with 1, 2, 4, ... worker threads and\n"
+        "report the throughput of all instances together and the time of single\n"
+        "run() calls. All instances get the same input and must send the same\n"
+        "output as an instance run alone.\n"
+        "\n"
+        "Options:\n"
+        "  -n, --blocks N     blocks of %u frames to process (default: 2000)\n"
+        "  -i, --instances N  instances per plugin (default: 32)\n"
+        "  -t, --threads N    maximum number of threads (default: number of CPUs, at least 2)\n"
+        "  -r, --repeat N     repetitions, the fastest one is reported (default: 3)\n"
+        "  -h, --help         show this help\n"
+        "\n"
+        "The exit status is 1 if the instances of any plugin differ or a plugin\n"
+        "could not be loaded.\n", kBlockSize);
+}
+
+int main(int argc, char** argv) {
+    static const struct option longOptions[] = {
+        {"blocks", required_argument, nullptr, 'n'},
+        {"instances", required_argument, nullptr, 'i'},
+        {"threads", required_argument, nullptr, 't'},
+        {"repeat", required_argument, nullptr, 'r'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+    uint32_t blocks = 2000;
+    uint32_t instances = 32;
+    uint32_t threads = std::max(2u, std::thread::hardware_concurrency());
+    uint32_t repeat = 3;
+    int status = 0;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "n:i:t:r:h", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 'n':
+                blocks = (uint32_t) std::atoi(optarg);
+                break;
+            case 'i':
+                instances = (uint32_t) std::atoi(optarg);
+                break;
+            case 't':
+                threads = (uint32_t) std::atoi(optarg);
+                break;
+            case 'r':
+                repeat = (uint32_t) std::atoi(optarg);
+                break;
+            case 'h':
+                usage(stdout);
+                return 0;
+            default:
+                usage(stderr);
+                return 2;
+        }
+    }
+
+    if (optind >= argc || blocks == 0 || instances == 0 || threads == 0 || repeat == 0) {
+        usage(stderr);
+        return 2;
+    }
+
+    const PlugBenchSchedule schedule(blocks);
+
+    std::printf("%u instances, %u blocks of %u frames, best of %u runs, up to %u threads\n\n", instances,
+                blocks, kBlockSize, repeat, threads);
+    std::printf("  %7s %12s %8s %10s %10s %10s  %s\n", "threads", "Mevents/s", "speedup", "p50 ns",
+                "p99 ns", "max ns", "check");
+
+    for (int i=optind; i < argc; i++) {
+        if (! benchPlugin(argv[i], schedule, instances, threads, repeat))
+            status = 1;
+    }
+
+    return status;
+}
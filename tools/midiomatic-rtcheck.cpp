@@ -0,0 +1,386 @@
+/*
+ * Realtime-safety test host for midiomatic plugins built with RT_CHECK=true
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+
+/*
+  A minimal VST2 host, which loads each given plugin, drives its run() with
+  MIDI events, parameter changes, program changes, state changes and
+  transport changes, and then asks the plugin how many realtime violations
+  MIDIRealtimeCheck.hpp has counted in run(). Build the plugins with
+  "make RT_CHECK=true" or use "make rtcheck" in the top-level directory.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <dlfcn.h>
+
+#include "MIDIVstHost.hpp"
+
+// -----------------------------------------------------------------------
+// Host
+
+static constexpr uint32_t kMaxBlockEvents = 64;
+static constexpr uint32_t kMaxChannels = 8;
+static constexpr uint32_t kMaxBlockSize = 4096;
+static const uint32_t blockSizes[] = {64, 512, kMaxBlockSize};
+static const float parameterValues[] = {0.0f, 0.25f, 0.5f, 0.75f, 1.0f};
+
+struct RtCheckHost {
+    double sampleRate;
+    uint32_t blockSize;
+    uint32_t blocksPerSetting;
+    bool processing;
+    VstTimeInfo timeInfo;
+    uint64_t blocks;
+    uint64_t eventsOut;
+    uint32_t random;
+
+    VstMidiEvent midiEvents[kMaxBlockEvents];
+    VstEventList<kMaxBlockEvents> eventList;
+    float buffers[kMaxChannels][kMaxBlockSize];
+    float* inputs[kMaxChannels];
+    float* outputs[kMaxChannels];
+
+    RtCheckHost() noexcept
+        : sampleRate(48000.0),
+          blockSize(blockSizes[0]),
+          blocksPerSetting(8),
+          processing(false),
+          blocks(0),
+          eventsOut(0),
+          random(1) {
+        std::memset(&timeInfo, 0, sizeof(timeInfo));
+        std::memset(midiEvents, 0, sizeof(midiEvents));
+        std::memset(buffers, 0, sizeof(buffers));
+
+        for (uint32_t i=0; i < kMaxChannels; i++) {
+            inputs[i] = buffers[i];
+            outputs[i] = buffers[i];
+        }
+    }
+
+    uint32_t nextRandom() noexcept {
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        return random;
+    }
+
+    void fillEvents(uint32_t count) noexcept;
+    void advanceTransport() noexcept;
+    void processBlocks(AEffect* effect, uint32_t count) noexcept;
+};
+
+static RtCheckHost sHost;
+
+static intptr_t hostCallback(AEffect*, int32_t opcode, int32_t, intptr_t, void* ptr, float) {
+    switch (opcode) {
+        case audioMasterVersion:
+            return 2400;
+        case audioMasterGetTime:
+            return (intptr_t) &sHost.timeInfo;
+        case audioMasterProcessEvents:
+            if (ptr != nullptr)
+                sHost.eventsOut += (uint32_t) ((VstEventList<1>*) ptr)->numEvents;
+            return 1;
+        case audioMasterGetSampleRate:
+            return (intptr_t) sHost.sampleRate;
+        case audioMasterGetBlockSize:
+            return sHost.blockSize;
+        case audioMasterGetCurrentProcessLevel:
+            return sHost.processing ? 2 : 1;
+        case audioMasterCanDo:
+            return vstHostCanDo((const char*) ptr);
+        default:
+            return 0;
+    }
+}
+
+/**
+  Fill the event list with @a count events of all channel message types and
+  some single-byte System Real-Time messages, on random channels and with
+  ascending frame offsets.
+*/
+void RtCheckHost::fillEvents(uint32_t count) noexcept {
+    static const uint8_t statusTypes[] = {0x80, 0x90, 0xA0, 0xB0, 0xC0, 0xD0, 0xE0, 0xF8, 0xFE};
+    uint32_t frame = 0;
+
+    for (uint32_t i=0; i < count; i++) {
+        VstMidiEvent& event(midiEvents[i]);
+        uint8_t status = statusTypes[nextRandom() % sizeof(statusTypes)];
+
+        if (status < 0xF0)
+            status |= nextRandom() % 16;
+
+        frame += nextRandom() % (blockSize / count + 1);
+
+        event.type = kVstMidiType;
+        event.byteSize = sizeof(VstMidiEvent);
+        event.deltaFrames = (int32_t) (frame < blockSize ? frame : blockSize - 1);
+        event.midiData[0] = (char) status;
+        event.midiData[1] = status < 0xF0 ? (char) (nextRandom() % 128) : 0;
+        event.midiData[2] = status < 0xF0 && (status & 0xF0) != 0xC0 && (status & 0xF0) != 0xD0
+            ? (char) (nextRandom() % 128) : 0;
+        event.midiData[3] = 0;
+        eventList.events[i] = &event;
+    }
+
+    eventList.numEvents = (int32_t) count;
+    eventList.reserved = 0;
+}
+
+/**
+  Move the transport on by one block. It starts, stops and jumps back now
+  and then, so the plugins see all transport changes.
+*/
+void RtCheckHost::advanceTransport() noexcept {
+    const uint32_t change = nextRandom() % 16;
+    const bool playing = (timeInfo.flags & kVstTransportPlaying) != 0;
+
+    timeInfo.flags = kVstPpqPosValid | kVstTempoValid | kVstBarsValid | kVstTimeSigValid
+        | (playing ? kVstTransportPlaying : 0);
+
+    if (change == 0) {
+        timeInfo.flags ^= kVstTransportPlaying | kVstTransportChanged;
+    } else if (change == 1) {
+        timeInfo.samplePos = 0.0;
+        timeInfo.flags |= kVstTransportChanged;
+    } else if (playing) {
+        timeInfo.samplePos += blockSize;
+    }
+
+    timeInfo.sampleRate = sampleRate;
+    timeInfo.tempo = 120.0;
+    timeInfo.ppqPos = timeInfo.samplePos / sampleRate * timeInfo.tempo / 60.0;
+    timeInfo.barStartPos = (double) ((uint64_t) timeInfo.ppqPos / 4 * 4);
+    timeInfo.timeSigNumerator = 4;
+    timeInfo.timeSigDenominator = 4;
+}
+
+void RtCheckHost::processBlocks(AEffect* effect, uint32_t count) noexcept {
+    for (uint32_t i=0; i < count; i++) {
+        const uint32_t numEvents = i % 4 == 3 ? kMaxBlockEvents : nextRandom() % 16;
+
+        advanceTransport();
+        processing = true;
+
+        if (numEvents > 0) {
+            fillEvents(numEvents);
+            effect->dispatcher(effect, effProcessEvents, 0, 0, &eventList, 0.0f);
+        }
+
+        effect->processReplacing(effect, inputs, outputs, (int32_t) blockSize);
+        processing = false;
+        blocks++;
+    }
+}
+
+// -----------------------------------------------------------------------
+
+typedef uint32_t (*ViolationsFunc)();
+
+struct RtCheckResult {
+    uint64_t blocks;
+    uint64_t eventsOut;
+    uint32_t violations;
+};
+
+static void setBlockSize(AEffect* effect, uint32_t blockSize) {
+    effect->dispatcher(effect, effStopProcess, 0, 0, nullptr, 0.0f);
+    effect->dispatcher(effect, effMainsChanged, 0, 0, nullptr, 0.0f);
+    sHost.blockSize = blockSize;
+    effect->dispatcher(effect, effSetBlockSize, 0, blockSize, nullptr, 0.0f);
+    effect->dispatcher(effect, effMainsChanged, 0, 1, nullptr, 0.0f);
+    effect->dispatcher(effect, effStartProcess, 0, 0, nullptr, 0.0f);
+}
+
+static void driveEffect(AEffect* effect) {
+    const uint32_t blocks = sHost.blocksPerSetting;
+
+    for (uint32_t size=0; size < sizeof(blockSizes) / sizeof(blockSizes[0]); size++) {
+        setBlockSize(effect, blockSizes[size]);
+        sHost.processBlocks(effect, blocks);
+
+        for (int32_t i=0; i < effect->numParams; i++) {
+            const float value = effect->getParameter(effect, i);
+
+            for (uint32_t v=0; v < sizeof(parameterValues) / sizeof(parameterValues[0]); v++) {
+                effect->setParameter(effect, i, parameterValues[v]);
+                sHost.processBlocks(effect, blocks);
+            }
+
+            effect->setParameter(effect, i, value);
+        }
+
+        for (int32_t i=0; i < effect->numPrograms; i++) {
+            effect->dispatcher(effect, effSetProgram, 0, i, nullptr, 0.0f);
+            sHost.processBlocks(effect, blocks);
+        }
+
+        if (effect->flags & kEffFlagsProgramChunks) {
+            void* data = nullptr;
+            const intptr_t size = effect->dispatcher(effect, effGetChunk, 0, 0, &data, 0.0f);
+            std::vector<char> saved;
+
+            if (size > 0 && data != nullptr)
+                saved.assign((const char*) data, (const char*) data + size);
+
+            for (uint32_t variant=0; variant < 3; variant++) {
+                std::string chunk = makeStateChunk(variant);
+
+                effect->dispatcher(effect, effSetChunk, 0, (intptr_t) chunk.size(), &chunk[0], 0.0f);
+                sHost.processBlocks(effect, blocks);
+            }
+
+            if (! saved.empty()) {
+                effect->dispatcher(effect, effSetChunk, 0, (intptr_t) saved.size(), saved.data(), 0.0f);
+                sHost.processBlocks(effect, blocks);
+            }
+        }
+    }
+}
+
+/**
+  Load the plugin at @a path, drive it and return the result in @a result.
+  Returns false and prints a message if the plugin could not be checked.
+*/
+static bool checkPlugin(const char* path, RtCheckResult& result) {
+    void* lib = nullptr;
+    AEffect* effect = loadVstPlugin(path, hostCallback, lib);
+
+    if (effect == nullptr) {
+        if (lib != nullptr)
+            dlclose(lib);
+        return false;
+    }
+
+    ViolationsFunc violations = (ViolationsFunc) dlsym(lib, "midiomatic_rt_check_violations");
+
+    if (violations == nullptr) {
+        std::fprintf(stderr, "%s: not built with RT_CHECK=true\n", path);
+        effect->dispatcher(effect, effClose, 0, 0, nullptr, 0.0f);
+        dlclose(lib);
+        return false;
+    }
+
+    if (effect->numInputs > (int32_t) kMaxChannels || effect->numOutputs > (int32_t) kMaxChannels) {
+        std::fprintf(stderr, "%s: too many audio channels\n", path);
+        effect->dispatcher(effect, effClose, 0, 0, nullptr, 0.0f);
+        dlclose(lib);
+        return false;
+    }
+
+    sHost.blocks = 0;
+    sHost.eventsOut = 0;
+    std::memset(&sHost.timeInfo, 0, sizeof(sHost.timeInfo));
+
+    effect->dispatcher(effect, effOpen, 0, 0, nullptr, 0.0f);
+    effect->dispatcher(effect, effSetSampleRate, 0, 0, nullptr, (float) sHost.sampleRate);
+    effect->dispatcher(effect, effSetBlockSize, 0, sHost.blockSize, nullptr, 0.0f);
+    effect->dispatcher(effect, effMainsChanged, 0, 1, nullptr, 0.0f);
+    effect->dispatcher(effect, effStartProcess, 0, 0, nullptr, 0.0f);
+
+    driveEffect(effect);
+
+    effect->dispatcher(effect, effStopProcess, 0, 0, nullptr, 0.0f);
+    effect->dispatcher(effect, effMainsChanged, 0, 0, nullptr, 0.0f);
+
+    result.blocks = sHost.blocks;
+    result.eventsOut = sHost.eventsOut;
+    result.violations = violations();
+
+    effect->dispatcher(effect, effClose, 0, 0, nullptr, 0.0f);
+    dlclose(lib);
+    return true;
+}
+
+static void usage(FILE* out) {
+    std::fprintf(out,
+        "Usage: midiomatic-rtcheck [OPTIONS] PLUGIN.so...\n"
+        "\n"
+        "Load each VST2 plugin, which must have been built with 'make RT_CHECK=true',\n"
+        "drive its run() with MIDI events and parameter, program, state and transport\n"
+        "changes at block sizes of 64, 512 and 4096 frames, and report the realtime\n"
+        "violations the plugin has counted.\n"
+        "\n"
+        "Options:\n"
+        "  -n, --blocks N  blocks to process per setting (default: 8)\n"
+        "  -h, --help      show this help\n"
+        "\n"
+        "The exit status is 1 if any plugin had violations or could not be checked.\n");
+}
+
+int main(int argc, char** argv) {
+    static const struct option longOptions[] = {
+        {"blocks", required_argument, nullptr, 'n'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+    int status = 0;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "n:h", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 'n':
+                sHost.blocksPerSetting = (uint32_t) std::atoi(optarg);
+                break;
+            case 'h':
+                usage(stdout);
+                return 0;
+            default:
+                usage(stderr);
+                return 2;
+        }
+    }
+
+    if (optind >= argc || sHost.blocksPerSetting == 0) {
+        usage(stderr);
+        return 2;
+    }
+
+    for (int i=optind; i < argc; i++) {
+        RtCheckResult result;
+
+        if (! checkPlugin(argv[i], result)) {
+            status = 1;
+            continue;
+        }
+
+        std::printf("%s: %llu blocks, %llu events out, %u realtime violation(s)\n", argv[i],
+                    (unsigned long long) result.blocks, (unsigned long long) result.eventsOut,
+                    result.violations);
+
+        if (result.violations > 0)
+            status = 1;
+    }
+
+    return status;
+}
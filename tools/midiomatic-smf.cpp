@@ -0,0 +1,379 @@
+/*
+ * Offline Standard MIDI File processor using the midiomatic plugin cores
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Copyright (C) 2026 Christopher Arndt <info@chrisarndt.de>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ * IN THE SOFTWARE.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+
+#include "MIDIFileBatch.hpp"
+#include "MIDIFilePipeline.hpp"
+#include "MIDIFileProcessing.hpp"
+#include "MIDIToolProcessors.hpp"
+
+USE_NAMESPACE_DISTRHO
+
+static void usage(FILE* out) {
+    std::fprintf(out,
+        "Usage: midiomatic-smf [OPTIONS] PROCESSOR INPUT.mid OUTPUT.mid\n"
+        "       midiomatic-smf [OPTIONS] PROCESSOR,PROCESSOR... INPUT.mid OUTPUT.mid\n"
+        "       midiomatic-smf [OPTIONS] PROCESSOR INPUTDIR OUTPUTDIR\n"
+        "       midiomatic-smf [OPTIONS] --sweep PROCESSOR INPUT.mid OUTPUT.mid\n"
+        "\n"
+        "Stream a Standard MIDI File through one of the midiomatic MIDI processors.\n"
+        "A comma-separated list of processors is run as a pipeline with one thread\n"
+        "per processor. Their parameters are set with PROCESSOR_SYMBOL=VALUE.\n"
+        "If INPUT is a directory, all MIDI files below it are processed in parallel\n"
+        "and written to the same relative paths below OUTPUTDIR.\n"
+        "With --sweep, the file is processed with block sizes from 16 to 8192 frames,\n"
+        "the cost of the processor is printed for each and the run fails if the output\n"
+        "differs between them.\n"
+        "\n"
+        "Options:\n"
+        "  -p, --param SYMBOL=VALUE  set a processor parameter (repeatable)\n"
+        "  -r, --rules FILE          read the rules for the 'rules' processor from FILE\n"
+        "  -s, --samplerate RATE     sample rate for converting ticks to frames (default: 48000)\n"
+        "  -b, --blocksize FRAMES    frames per processing block (default: 256)\n"
+        "  -j, --jobs N              number of worker threads for directories\n"
+        "                            (default: number of CPUs)\n"
+        "  -w, --sweep               process the file with all block sizes from 16 to 8192\n"
+        "  -l, --list                list the processors and their parameters\n"
+        "  -q, --quiet               don't print event counts\n"
+        "  -h, --help                show this help\n");
+}
+
+/**
+  Create a processor for each of @a names and apply the parameter settings
+  of the form "processor_symbol=value" and the rules file to all processors
+  of that name. Returns false and prints an error message on failure.
+*/
+static bool createProcessorChain(const std::vector<std::string>& names, const std::vector<const char*>& params,
+                                 const char* rulesPath, std::vector<MidiProcessor*>& stages) {
+    bool haveRules = false;
+
+    for (size_t i=0; i < names.size(); i++) {
+        MidiProcessor* processor = createMidiProcessor(names[i].c_str());
+
+        if (processor == nullptr) {
+            std::fprintf(stderr, "Unknown processor '%s', use --list to show the available ones.\n",
+                         names[i].c_str());
+            return false;
+        }
+
+        stages.push_back(processor);
+
+        if (names[i] == "rules") {
+            haveRules = true;
+
+            if (rulesPath != nullptr && !loadMidiProcessorRules(*processor, rulesPath))
+                return false;
+        }
+    }
+
+    if (rulesPath != nullptr && !haveRules) {
+        std::fprintf(stderr, "--rules needs a 'rules' processor in the chain.\n");
+        return false;
+    }
+
+    for (size_t i=0; i < params.size(); i++) {
+        bool found = false;
+
+        for (size_t j=0; j < names.size(); j++) {
+            const std::string prefix = names[j] + "_";
+
+            if (std::strncmp(params[i], prefix.c_str(), prefix.size()) == 0) {
+                if (!setMidiProcessorParameter(*stages[j], params[i] + prefix.size()))
+                    return false;
+
+                found = true;
+            }
+        }
+
+        if (!found) {
+            std::fprintf(stderr, "Parameter '%s' is not for any processor of the chain, "
+                         "use PROCESSOR_SYMBOL=VALUE.\n", params[i]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool readFileData(const char* path, std::vector<uint8_t>& data) {
+    FILE* file = std::fopen(path, "rb");
+    uint8_t buffer[4096];
+    size_t size;
+
+    if (file == nullptr)
+        return false;
+
+    data.clear();
+
+    while ((size = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+        data.insert(data.end(), buffer, buffer + size);
+
+    const bool ok = !std::ferror(file);
+    std::fclose(file);
+    return ok;
+}
+
+static const uint32_t sweepBlockSizes[] = {16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192};
+
+/**
+  Process @a inPath with a new processor for each of the sweepBlockSizes,
+  calling process() for the empty blocks too, like a host, and print the
+  time spent in process() per call, per frame and per input event.
+  Since output events get the ticks of the input events, the output written
+  to @a outPath must be the same for all block sizes.
+  Returns false if it differs or processing fails.
+*/
+static bool sweepMidiFile(const char* name, const std::vector<const char*>& params, const char* rulesPath,
+                          const char* inPath, const char* outPath, MidiFileProcessingOptions options) {
+    std::vector<uint8_t> reference, output;
+    bool ok = true;
+
+    std::printf("%-6s %10s %10s %10s %10s  %s\n", "block", "calls", "ns/call", "ns/frame", "ns/event", "output");
+    options.emptyBlocks = true;
+
+    for (uint32_t i=0; i < sizeof(sweepBlockSizes) / sizeof(sweepBlockSizes[0]); i++) {
+        MidiProcessor* processor = createConfiguredMidiProcessor(name, params, rulesPath);
+        MidiFileProcessingStats stats;
+
+        if (processor == nullptr)
+            return false;
+
+        options.blockSize = sweepBlockSizes[i];
+        const bool processed = processMidiFile(inPath, outPath, *processor, options, stats);
+        delete processor;
+
+        if (!processed || !readFileData(outPath, i == 0 ? reference : output)) {
+            std::fprintf(stderr, "%s: could not process the file with a block size of %u.\n", inPath,
+                         options.blockSize);
+            return false;
+        }
+
+        std::printf("%-6u %10llu %10.1f %10.3f %10.1f  ", options.blockSize, (unsigned long long) stats.blocks,
+                    stats.blocks > 0 ? 1e9 * stats.processSeconds / stats.blocks : 0.0,
+                    stats.frames > 0 ? 1e9 * stats.processSeconds / stats.frames : 0.0,
+                    stats.eventsIn > 0 ? 1e9 * stats.processSeconds / stats.eventsIn : 0.0);
+
+        if (i == 0) {
+            std::printf("reference\n");
+        }
+        else if (output == reference) {
+            std::printf("same\n");
+        }
+        else {
+            std::printf("DIFFERS\n");
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+static void printEventCounts(const MidiFileProcessingStats& stats) {
+    std::fprintf(stderr, "%llu events in, %llu events out", (unsigned long long) stats.eventsIn,
+                 (unsigned long long) stats.eventsOut);
+
+    if (stats.eventsDropped > 0)
+        std::fprintf(stderr, ", %llu dropped", (unsigned long long) stats.eventsDropped);
+
+    std::fprintf(stderr, "\n");
+}
+
+int main(int argc, char** argv) {
+    static const struct option longOptions[] = {
+        {"param", required_argument, nullptr, 'p'},
+        {"rules", required_argument, nullptr, 'r'},
+        {"samplerate", required_argument, nullptr, 's'},
+        {"blocksize", required_argument, nullptr, 'b'},
+        {"jobs", required_argument, nullptr, 'j'},
+        {"sweep", no_argument, nullptr, 'w'},
+        {"list", no_argument, nullptr, 'l'},
+        {"quiet", no_argument, nullptr, 'q'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0}
+    };
+    std::vector<const char*> params;
+    const char* rulesPath = nullptr;
+    MidiFileProcessingOptions options;
+    MidiFileProcessingStats stats;
+    uint32_t numThreads = std::thread::hardware_concurrency();
+    bool quiet = false;
+    bool sweep = false;
+    struct stat st;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "p:r:s:b:j:wlqh", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 'p':
+                params.push_back(optarg);
+                break;
+            case 'r':
+                rulesPath = optarg;
+                break;
+            case 's':
+                options.sampleRate = std::atof(optarg);
+                break;
+            case 'b':
+                options.blockSize = (uint32_t) std::atoi(optarg);
+                break;
+            case 'j':
+                numThreads = (uint32_t) std::atoi(optarg);
+                break;
+            case 'w':
+                sweep = true;
+                break;
+            case 'l':
+                listMidiProcessors(stdout);
+                return 0;
+            case 'q':
+                quiet = true;
+                break;
+            case 'h':
+                usage(stdout);
+                return 0;
+            default:
+                usage(stderr);
+                return 2;
+        }
+    }
+
+    if (argc - optind != 3 || options.sampleRate <= 0.0 || options.blockSize == 0) {
+        usage(stderr);
+        return 2;
+    }
+
+    const char* name = argv[optind];
+    const char* inPath = argv[optind + 1];
+    const char* outPath = argv[optind + 2];
+    const bool isDirectory = stat(inPath, &st) == 0 && S_ISDIR(st.st_mode);
+
+    if (sweep) {
+        if (isDirectory || std::strchr(name, ',') != nullptr) {
+            std::fprintf(stderr, "--sweep needs a single processor and input file.\n");
+            return 2;
+        }
+
+        return sweepMidiFile(name, params, rulesPath, inPath, outPath, options) ? 0 : 1;
+    }
+
+    if (std::strchr(name, ',') != nullptr) {
+        std::vector<std::string> names;
+        std::vector<MidiProcessor*> stages;
+        MidiFilePipelineStats pipeline;
+        bool configured = false;
+        bool ok = false;
+
+        for (const char* pos = name;; pos++) {
+            const char* end = std::strchr(pos, ',');
+
+            names.push_back(end != nullptr ? std::string(pos, end - pos) : std::string(pos));
+
+            if (end == nullptr)
+                break;
+
+            pos = end;
+        }
+
+        if (isDirectory)
+            std::fprintf(stderr, "Processor chains can only be used with a single input file.\n");
+        else
+            configured = createProcessorChain(names, params, rulesPath, stages);
+
+        if (configured)
+            ok = processMidiFilePipeline(inPath, outPath, stages, options, pipeline);
+
+        if (ok && !quiet) {
+            const double seconds = pipeline.seconds > 0.0 ? pipeline.seconds : 1e-9;
+
+            printEventCounts(pipeline.events);
+            std::fprintf(stderr, "%.3f s, %.0f events/s\n", pipeline.seconds,
+                         pipeline.events.eventsIn / seconds);
+            std::fprintf(stderr, "  %-14s %5.1f%% busy\n", "(read)", 100.0 * pipeline.busySeconds.front() / seconds);
+
+            for (size_t i=0; i < names.size(); i++)
+                std::fprintf(stderr, "  %-14s %5.1f%% busy\n", names[i].c_str(),
+                             100.0 * pipeline.busySeconds[i + 1] / seconds);
+
+            std::fprintf(stderr, "  %-14s %5.1f%% busy\n", "(write)", 100.0 * pipeline.busySeconds.back() / seconds);
+        }
+
+        for (size_t i=0; i < stages.size(); i++)
+            delete stages[i];
+
+        return ok ? 0 : (configured ? 1 : 2);
+    }
+
+    MidiProcessor* processor = createConfiguredMidiProcessor(name, params, rulesPath);
+
+    if (processor == nullptr)
+        return 2;
+
+    if (isDirectory) {
+        std::vector<MidiFileJob> jobs;
+        MidiFileBatchStats batch;
+
+        // the instance above only checked the settings, each worker makes its own
+        delete processor;
+
+        if (!collectMidiFileJobs(inPath, outPath, jobs))
+            return 1;
+
+        const bool ok = processMidiFileBatch(jobs, [&]() {
+            return createConfiguredMidiProcessor(name, params, rulesPath);
+        }, options, numThreads, batch);
+
+        if (!quiet) {
+            const double seconds = batch.seconds > 0.0 ? batch.seconds : 1e-9;
+
+            std::fprintf(stderr, "%llu files", (unsigned long long) batch.files);
+
+            if (batch.filesFailed > 0)
+                std::fprintf(stderr, " (%llu failed)", (unsigned long long) batch.filesFailed);
+
+            std::fprintf(stderr, ", ");
+            printEventCounts(batch.events);
+            std::fprintf(stderr, "%.3f s, %.1f files/s, %.0f events/s\n", batch.seconds,
+                         batch.files / seconds, batch.events.eventsIn / seconds);
+        }
+
+        return ok ? 0 : 1;
+    }
+
+    const bool ok = processMidiFile(inPath, outPath, *processor, options, stats);
+
+    if (ok && !quiet)
+        printEventCounts(stats);
+
+    delete processor;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+#!/bin/bash
+#
+# Checks of midiomatic-smf on a generated Standard MIDI File
+#
+# Usage: check-smf.sh [BINDIR]
+#
+# Every processor must give the same output for all block sizes, and the
+# batch mode must give the same output as processing the files one by one.
+#
+
+set -e
+
+bindir=${1:-../bin}
+tests=$(dirname "$0")
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+"$tests"/make-test-smf.sh "$tmp/test.mid"
+printf 'noteon : emit cc 1 d2\ncc 1-63 : map cc 7\npb : map pressure d2\npc : drop\n' > "$tmp/test.rules"
+
+while read -r processor args; do
+    echo "== sweep: $processor $args =="
+    "$bindir"/midiomatic-smf --sweep $args "$processor" "$tmp/test.mid" "$tmp/out.mid"
+done <<EOT
+ccmapx4 -p cc1_mode=1 -p cc1_filterdups=1 -p cc2_mode=2
+cctopressure
+pbtocc
+pressuretocc
+rules -r $tmp/test.rules
+sysfilter
+EOT
+
+mkdir -p "$tmp/in/1" "$tmp/in/2" "$tmp/batch"
+
+for seed in 1 2 3 4 5 6 7 8; do
+    "$tests"/make-test-smf.sh "$tmp/in/$(( seed % 2 ? 1 : 2 ))/$seed.mid" $seed
+done
+
+while read -r processor args; do
+    echo "== batch: $processor $args =="
+    "$bindir"/midiomatic-smf -q -j 4 $args "$processor" "$tmp/in" "$tmp/batch"
+
+    for input in "$tmp"/in/*/*.mid; do
+        "$bindir"/midiomatic-smf -q $args "$processor" "$input" "$tmp/single.mid"
+
+        if ! cmp -s "$tmp/single.mid" "$tmp/batch/${input#$tmp/in/}"; then
+            echo "${input#$tmp/in/}: BATCH OUTPUT DIFFERS"
+            exit 1
+        fi
+    done
+
+    echo "same"
+done <<EOT
+ccmapx4 -p cc1_mode=1 -p cc1_filterdups=1 -p cc2_mode=2 -p cc2_filterdups=1
+rules -r $tmp/test.rules
+EOT
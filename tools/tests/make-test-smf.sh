@@ -0,0 +1,126 @@
+#!/bin/bash
+#
+# Write a Standard MIDI File for the checks of the midiomatic tools
+#
+# Usage: make-test-smf.sh OUTPUT.mid [SEED]
+#
+# The file has a tempo track with tempo changes and a track with about 2000
+# events of all channel message types, SysEx messages and meta events in
+# between, at irregular times. It starts and ends with CC 1 = 64 on all
+# channels, so a duplicate filter, which keeps its state from one file to the
+# next, changes the output. The same SEED gives the same file.
+#
+
+set -e
+
+if [ $# -lt 1 ]; then
+    echo "Usage: $0 OUTPUT.mid [SEED]" >&2
+    exit 2
+fi
+
+RANDOM=${2:-1}
+
+data=""
+length=0
+
+emit() {
+    local byte hex
+
+    for byte in "$@"; do
+        printf -v hex '\\x%02x' $(( byte & 0xFF ))
+        data+=$hex
+        length=$(( length + 1 ))
+    done
+}
+
+varlen() {
+    local value=$1
+    local bytes=( $(( value & 0x7F )) )
+
+    while (( (value >>= 7) > 0 )); do
+        bytes=( $(( (value & 0x7F) | 0x80 )) "${bytes[@]}" )
+    done
+
+    emit "${bytes[@]}"
+}
+
+# Start a track chunk, its data is collected in $data
+begin_track() {
+    data=""
+    length=0
+}
+
+end_track() {
+    varlen 0
+    emit 0xFF 0x2F 0x00
+    track_data=$data
+    track_length=$length
+    data=""
+    emit 0x4D 0x54 0x72 0x6B $(( track_length >> 24 )) $(( track_length >> 16 )) \
+        $(( track_length >> 8 )) $track_length
+    file+=$data$track_data
+}
+
+file=""
+data=""
+emit 0x4D 0x54 0x68 0x64 0 0 0 6  0 1  0 2  0x01 0xE0
+file=$data
+
+# Tempo track: 120 BPM, 4/4, then a few tempo changes
+begin_track
+varlen 0; emit 0xFF 0x51 3 0x07 0xA1 0x20
+varlen 0; emit 0xFF 0x58 4 4 2 24 8
+
+for tempo in 400000 600000 350000 500000; do
+    varlen $(( 1920 + RANDOM % 1920 ))
+    emit 0xFF 0x51 3 $(( tempo >> 16 )) $(( tempo >> 8 )) $tempo
+done
+
+end_track
+
+controller_reset() {
+    local channel
+
+    for (( channel=0; channel < 16; channel++ )); do
+        varlen 0
+        emit $(( 0xB0 | channel )) 1 64
+    done
+}
+
+# Events track
+begin_track
+varlen 0; emit 0xFF 0x03 6 0x45 0x76 0x65 0x6E 0x74 0x73
+controller_reset
+
+for (( i=0; i < 2000; i++ )); do
+    # mostly short deltas, some events at the same tick, some long gaps
+    case $(( RANDOM % 16 )) in
+        0|1|2) delta=0 ;;
+        3) delta=$(( RANDOM % 2000 )) ;;
+        *) delta=$(( RANDOM % 60 )) ;;
+    esac
+
+    channel=$(( RANDOM % 16 ))
+    varlen $delta
+
+    case $(( RANDOM % 20 )) in
+        0|1|2) emit $(( 0x90 | channel )) $(( RANDOM % 128 )) $(( 1 + RANDOM % 127 )) ;;
+        3|4) emit $(( 0x80 | channel )) $(( RANDOM % 128 )) 0 ;;
+        5) emit $(( 0xA0 | channel )) $(( RANDOM % 128 )) $(( RANDOM % 128 )) ;;
+        6|7|8) emit $(( 0xB0 | channel )) 1 $(( RANDOM % 128 )) ;;
+        # repeated values, for the duplicate filters
+        9|10) emit $(( 0xB0 | channel )) 1 $(( (i / 8) % 128 )) ;;
+        11) emit $(( 0xB0 | channel )) $(( RANDOM % 128 )) $(( RANDOM % 128 )) ;;
+        12) emit $(( 0xC0 | channel )) $(( RANDOM % 128 )) ;;
+        13|14) emit $(( 0xD0 | channel )) $(( RANDOM % 128 )) ;;
+        15|16|17) emit $(( 0xE0 | channel )) $(( RANDOM % 128 )) $(( RANDOM % 128 )) ;;
+        18) emit 0xF0; varlen 5; emit 0x7E 0x7F 0x06 0x01 0xF7 ;;
+        19) emit 0xFF 0x01 4 0x54 0x65 0x78 0x74 ;;
+    esac
+done
+
+controller_reset
+
+end_track
+
+printf '%b' "$file" > "$1"